@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+
+#include "Benchmark.h"
+
+namespace {
+
+	const size_t ID_WIDTH = 56;
+
+	// Upper bound on calibration so that empty bodies don't spin forever
+	const size_t MAX_ITERATIONS = 1000000000;
+
+	double measure(const Benchmark::Runner::Body& body, size_t iterations) {
+		Benchmark::Timer timer;
+		for (size_t i = 0; i < iterations; i++) {
+			body(timer);
+		}
+		return timer.getElapsed();
+	}
+
+	std::string makeId(const std::string& name, const Benchmark::Params& params) {
+		std::string id = name;
+		for (const auto& param : params) {
+			id += "/" + param.first + "=" + std::to_string(param.second);
+		}
+		return id;
+	}
+
+	/*
+	 * Reads "key": value pairs back from lines written by printJson, false if line holds no result
+	 */
+	bool parseResultLine(const std::string& line, std::string& id, double& nsPerOp) {
+		const std::string idKey = "\"id\": \"";
+		const std::string timeKey = "\"ns_per_op\": ";
+
+		size_t idPos = line.find(idKey);
+		size_t timePos = line.find(timeKey);
+		if (idPos == std::string::npos || timePos == std::string::npos) {
+			return false;
+		}
+
+		idPos += idKey.size();
+		size_t idEnd = line.find('"', idPos);
+		if (idEnd == std::string::npos) {
+			return false;
+		}
+
+		id = line.substr(idPos, idEnd - idPos);
+		nsPerOp = strtod(line.c_str() + timePos + timeKey.size(), nullptr);
+		return nsPerOp > 0;
+	}
+
+} // namespace
+
+void Benchmark::Timer::pause() {
+	if (m_isRunning) {
+		m_elapsed += std::chrono::duration<double>(Clock::now() - m_start).count();
+		m_isRunning = false;
+	}
+}
+
+void Benchmark::Timer::resume() {
+	if (!m_isRunning) {
+		m_start = Clock::now();
+		m_isRunning = true;
+	}
+}
+
+double Benchmark::Timer::getElapsed() const {
+	if (m_isRunning) {
+		return m_elapsed + std::chrono::duration<double>(Clock::now() - m_start).count();
+	}
+	return m_elapsed;
+}
+
+void Benchmark::consume(double value) {
+	static volatile double sink;
+	sink = value;
+	// Never read otherwise, -Wall reports it as set but not used
+	(void)sink;
+}
+
+Benchmark::Runner::Runner(double minTime, const std::string& filter, std::ostream& log)
+	: m_minTime(minTime), m_filter(filter), m_log(log) {}
+
+void Benchmark::Runner::run(const std::string& name, const Params& params, size_t opsPerCall, const Body& body) {
+	std::string id = makeId(name, params);
+	if (!m_filter.empty() && id.find(m_filter) == std::string::npos) {
+		return;
+	}
+
+	// Grow iterations until a single round takes its share of minTime
+	double roundTime = m_minTime / ROUNDS;
+	size_t iterations = 1;
+	for (;;) {
+		double elapsed = measure(body, iterations);
+		if (elapsed >= roundTime || iterations >= MAX_ITERATIONS) {
+			break;
+		}
+
+		double growth = elapsed > 0 ? 1.2 * roundTime / elapsed : 100;
+		growth = std::min(std::max(growth, 2.0), 100.0);
+		iterations = std::min(static_cast<size_t>(iterations * growth), MAX_ITERATIONS);
+	}
+
+	// Median is stable against rounds disturbed by the rest of the system
+	std::vector<double> rounds;
+	for (size_t i = 0; i < ROUNDS; i++) {
+		rounds.push_back(measure(body, iterations) * 1.0e9 / (iterations * opsPerCall));
+	}
+	std::sort(rounds.begin(), rounds.end());
+
+	Result result = { id, name, params, iterations, rounds[ROUNDS / 2] };
+	m_results.push_back(result);
+
+	if (m_results.size() == 1) {
+		m_log << std::left << std::setw(ID_WIDTH) << "Benchmark" << std::right << std::setw(12) << "Iterations"
+			  << std::setw(16) << "ns/op" << std::endl;
+	}
+	m_log << std::left << std::setw(ID_WIDTH) << id << std::right << std::setw(12) << iterations << std::setw(16)
+		  << std::fixed << std::setprecision(1) << result.nsPerOp << std::defaultfloat << std::setprecision(6)
+		  << std::endl;
+}
+
+const std::vector<Benchmark::Result>& Benchmark::Runner::getResults() const { return m_results; }
+
+void Benchmark::Runner::addContext(const std::string& key, const std::string& value) {
+	m_context.push_back(std::make_pair(key, value));
+}
+
+std::string Benchmark::Runner::getContextLine() const {
+	std::string line = "\"context\": { ";
+	for (size_t i = 0; i < m_context.size(); i++) {
+		line += (i ? ", \"" : "\"") + m_context[i].first + "\": \"" + m_context[i].second + "\"";
+	}
+	return line + " },";
+}
+
+void Benchmark::Runner::printJson(std::ostream& out) const {
+	out << "{\n\t" << getContextLine() << "\n\t\"benchmarks\": [\n";
+
+	for (size_t i = 0; i < m_results.size(); i++) {
+		const Result& result = m_results[i];
+
+		out << "\t\t{ \"id\": \"" << result.id << "\", \"name\": \"" << result.name << "\", \"params\": { ";
+		for (size_t j = 0; j < result.params.size(); j++) {
+			out << (j ? ", " : "") << "\"" << result.params[j].first << "\": " << result.params[j].second;
+		}
+		out << " }, \"iterations\": " << result.iterations << ", \"ns_per_op\": " << std::setprecision(6)
+			<< result.nsPerOp << " }" << (i + 1 < m_results.size() ? "," : "") << "\n";
+	}
+
+	out << "\t]\n}\n";
+}
+
+size_t Benchmark::Runner::compare(std::istream& baseline, double threshold, std::ostream& out) const {
+	std::map<std::string, double> baselineResults;
+	std::string baselineContext;
+
+	std::string line;
+	while (std::getline(baseline, line)) {
+		std::string id;
+		double nsPerOp;
+		if (parseResultLine(line, id, nsPerOp)) {
+			baselineResults[id] = nsPerOp;
+		} else if (line.find("\"context\": ") != std::string::npos) {
+			baselineContext = line.substr(line.find_first_not_of(" \t"));
+		}
+	}
+
+	if (baselineContext != getContextLine()) {
+		out << "Warning: baseline was measured in a different context" << std::endl;
+		out << "  baseline: " << baselineContext << std::endl;
+		out << "  current:  " << getContextLine() << std::endl;
+	}
+
+	out << std::left << std::setw(ID_WIDTH) << "Benchmark" << std::right << std::setw(16) << "Baseline ns/op"
+		<< std::setw(16) << "ns/op" << std::setw(10) << "Ratio" << std::endl;
+
+	size_t regressions = 0;
+	for (const Result& result : m_results) {
+		out << std::left << std::setw(ID_WIDTH) << result.id << std::right << std::fixed << std::setprecision(1);
+
+		auto found = baselineResults.find(result.id);
+		if (found == baselineResults.end()) {
+			out << std::setw(16) << "-" << std::setw(16) << result.nsPerOp << std::setw(10) << "-" << "  new";
+		} else {
+			double ratio = result.nsPerOp / found->second;
+			out << std::setw(16) << found->second << std::setw(16) << result.nsPerOp << std::setw(10)
+				<< std::setprecision(2) << ratio;
+
+			if (ratio > 1 + threshold) {
+				out << "  REGRESSION";
+				regressions++;
+			} else if (ratio < 1 - threshold) {
+				out << "  improvement";
+			}
+		}
+		out << std::defaultfloat << std::setprecision(6) << std::endl;
+	}
+
+	return regressions;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Benchmark {
+
+	using Params = std::vector<std::pair<std::string, size_t>>;
+
+	/*
+	 * Measures time spent in benchmark body, work done between pause and resume is not counted
+	 */
+	class Timer {
+	public:
+		void pause();
+		void resume();
+
+		double getElapsed() const;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		Clock::time_point m_start = Clock::now();
+		double m_elapsed = 0;
+		bool m_isRunning = true;
+	};
+
+	/*
+	 * Keeps computed value from being optimized away
+	 */
+	void consume(double value);
+
+	struct Result {
+		// Stable between runs: name followed by params, e.g. "Vector/dot/dim=1000"
+		std::string id;
+		std::string name;
+		Params params;
+
+		size_t iterations;
+
+		// Median over rounds
+		double nsPerOp;
+	};
+
+	class Runner {
+	public:
+		using Body = std::function<void(Timer&)>;
+
+		/*
+		 * Benchmarks with id not containing filter are skipped, empty filter runs everything.
+		 * Human readable row is written to log as soon as a benchmark is done
+		 */
+		Runner(double minTime, const std::string& filter, std::ostream& log);
+
+		/*
+		 * Calls body until minTime seconds are measured, one call of body performs opsPerCall operations
+		 */
+		void run(const std::string& name, const Params& params, size_t opsPerCall, const Body& body);
+
+		const std::vector<Result>& getResults() const;
+
+		/*
+		 * Conditions results depend on, e.g. build type, written to JSON and checked by compare
+		 */
+		void addContext(const std::string& key, const std::string& value);
+
+		/*
+		 * One result per line, so that files can be diffed and read back by compare
+		 */
+		void printJson(std::ostream& out) const;
+
+		/*
+		 * Prints ratio to baseline for each result present in both runs, returns amount of results
+		 * slower than baseline by more than threshold. Baseline of different context is only warned about
+		 */
+		size_t compare(std::istream& baseline, double threshold, std::ostream& out) const;
+
+	private:
+		static const size_t ROUNDS = 5;
+
+		std::string getContextLine() const;
+
+		double m_minTime;
+		std::string m_filter;
+		std::ostream& m_log;
+
+		std::vector<std::pair<std::string, std::string>> m_context;
+		std::vector<Result> m_results;
+	};
+
+} // namespace Benchmark
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ICompact.h>
+#include <ILogger.h>
+
+#include "Benchmark.h"
+
+namespace Benchmarks {
+	void vectorBenchmark(Benchmark::Runner& runner, ILogger* logger);
+	void setBenchmark(Benchmark::Runner& runner, ILogger* logger);
+	void compactBenchmark(Benchmark::Runner& runner, ILogger* logger);
+	void problemBenchmark(Benchmark::Runner& runner, ILogger* logger);
+	void solverBenchmark(Benchmark::Runner& runner, ILogger* logger);
+
+	/*
+	 * Cube [-bound, bound]^dim with nodes nodes along every axis
+	 */
+	ICompact* createDomain(size_t dim, double bound, size_t nodes);
+}
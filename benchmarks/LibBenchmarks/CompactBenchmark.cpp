@@ -0,0 +1,41 @@
+#include <vector>
+
+#include <ICompact.h>
+
+#include "Benchmarks.h"
+
+void Benchmarks::compactBenchmark(Benchmark::Runner& runner, ILogger* logger) {
+	ICompact::setLogger(logger);
+	ICompact::IIterator::setLogger(logger);
+
+	for (size_t dim : { 2, 4 }) {
+		for (size_t nodes : { 10, 30 }) {
+			size_t total = 1;
+			std::vector<size_t> orderData(dim);
+			for (size_t i = 0; i < dim; i++) {
+				total *= nodes;
+				orderData[i] = i;
+			}
+
+			Benchmark::Params params = { { "dim", dim }, { "nodes", nodes } };
+
+			ICompact* compact = createDomain(dim, 1.0, nodes);
+			IMultiIndex* order = IMultiIndex::createMultiIndex(dim, orderData.data());
+			IVector* coords = IVector::createVector(dim, std::vector<double>(dim).data());
+
+			// Whole grid is passed reading coordinates of every node
+			runner.run("Compact/iteration", params, total, [&](Benchmark::Timer&) {
+				ICompact::IIterator* it = compact->getBegin(order);
+				for (; it->isValid(); it->next()) {
+					it->getVectorCoords(coords);
+				}
+				Benchmark::consume(coords->getData()[0]);
+				delete it;
+			});
+
+			delete coords;
+			delete order;
+			delete compact;
+		}
+	}
+}
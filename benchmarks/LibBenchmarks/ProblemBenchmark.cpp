@@ -0,0 +1,62 @@
+#include <vector>
+
+#include <IDiffProblem.h>
+
+#include "Benchmarks.h"
+#include "DllLoader.h"
+
+ICompact* Benchmarks::createDomain(size_t dim, double bound, size_t nodes) {
+	IVector* leftBound = IVector::createVector(dim, std::vector<double>(dim, -bound).data());
+	IVector* rightBound = IVector::createVector(dim, std::vector<double>(dim, bound).data());
+	IMultiIndex* grid = IMultiIndex::createMultiIndex(dim, std::vector<size_t>(dim, nodes).data());
+
+	ICompact* domain = ICompact::createCompact(leftBound, rightBound, grid);
+
+	delete leftBound;
+	delete rightBound;
+	delete grid;
+
+	return domain;
+}
+
+void Benchmarks::problemBenchmark(Benchmark::Runner& runner, ILogger* logger) {
+	DllLoader problemLoader;
+	if (!problemLoader.loadLibrary("libProblem")) {
+		return;
+	}
+	auto problem = reinterpret_cast<IDiffProblem*>(problemLoader.loadImplementation(IBroker::INTERFACE_IMPL::IPROBLEM));
+
+	// Same problem as in tests: 3x^4 + 2y^2 - sin(4x)
+	size_t argDim = 2;
+	size_t paramDim = 4;
+
+	ICompact* argsDomain = createDomain(argDim, 20, 100);
+	ICompact* paramsDomain = createDomain(paramDim, 10, 50);
+
+	problem->setArgsDomain(argsDomain, logger);
+	problem->setParamsDomain(paramsDomain);
+
+	IVector* paramPoint = IVector::createVector(paramDim, std::vector<double>{ 3, 2, -1, 4 }.data());
+	problem->setParams(paramPoint);
+
+	IVector* args = IVector::createVector(argDim, std::vector<double>{ 0.5, -1.5 }.data());
+	IVector* gradient = IVector::createVector(argDim, std::vector<double>(argDim).data());
+
+	Benchmark::Params params = { { "dim", argDim } };
+
+	runner.run("Problem/evalByArgs", params, 1, [&](Benchmark::Timer&) {
+		Benchmark::consume(problem->evalByArgs(args));
+	});
+
+	runner.run("Problem/evalGradientByArgs", params, 1, [&](Benchmark::Timer&) {
+		problem->evalGradientByArgs(args, gradient);
+		Benchmark::consume(gradient->getData()[0]);
+	});
+
+	delete gradient;
+	delete args;
+	delete paramPoint;
+	delete argsDomain;
+	delete paramsDomain;
+	delete problem;
+}
@@ -0,0 +1,207 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ISet.h>
+
+#include "Benchmarks.h"
+
+namespace {
+
+	std::vector<IVector*> randomVectors(size_t count, size_t dim, std::mt19937& generator) {
+		std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+		std::vector<IVector*> vectors;
+		std::vector<double> data(dim);
+		for (size_t i = 0; i < count; i++) {
+			for (auto& value : data) {
+				value = distribution(generator);
+			}
+			vectors.push_back(IVector::createVector(dim, data.data()));
+		}
+		return vectors;
+	}
+
+	/*
+	 * Insert, lookup and removal of the same vectors in a set with given index
+	 */
+	void runSetBenchmarks(Benchmark::Runner& runner, const std::string& prefix, ISet::INDEX index,
+						  const std::vector<IVector*>& vectors, const Benchmark::Params& params) {
+		auto n = IVector::NORM::SECOND;
+		double tol = 1.0e-6;
+		size_t size = vectors.size();
+
+		runner.run(prefix + "insert", params, size, [&](Benchmark::Timer& timer) {
+			timer.pause();
+			ISet* set = ISet::createSet();
+			set->setIndex(index);
+			timer.resume();
+
+			for (auto vec : vectors) {
+				set->insert(vec, n, tol);
+			}
+
+			timer.pause();
+			delete set;
+			timer.resume();
+		});
+
+		std::vector<double> block;
+		for (auto vec : vectors) {
+			block.insert(block.end(), vec->getData(), vec->getData() + vec->getDim());
+		}
+
+		runner.run(prefix + "insertMany", params, size, [&](Benchmark::Timer& timer) {
+			timer.pause();
+			ISet* set = ISet::createSet();
+			set->setIndex(index);
+			timer.resume();
+
+			set->insertMany(size, vectors[0]->getDim(), block.data(), n, tol);
+
+			timer.pause();
+			delete set;
+			timer.resume();
+		});
+
+		ISet* set = ISet::createSet();
+		set->setIndex(index);
+		for (auto vec : vectors) {
+			set->insert(vec, n, tol);
+		}
+
+		// Patterns are taken in order, so linear scan passes half of the set on average
+		size_t next = 0;
+		runner.run(prefix + "findFirst", params, 1, [&](Benchmark::Timer&) {
+			Benchmark::consume(static_cast<double>(set->findFirst(vectors[next], n, tol)));
+			next = (next + 1) % size;
+		});
+
+		runner.run(prefix + "remove", params, size, [&](Benchmark::Timer& timer) {
+			timer.pause();
+			ISet* copy = set->clone();
+			copy->findFirst(vectors[0], n, tol);
+			timer.resume();
+
+			for (auto vec : vectors) {
+				copy->remove(vec, n, tol);
+			}
+
+			timer.pause();
+			delete copy;
+			timer.resume();
+		});
+
+		// Every removal from the front used to move the whole rest of the set
+		runner.run(prefix + "removeFront", params, size, [&](Benchmark::Timer& timer) {
+			timer.pause();
+			ISet* copy = set->clone();
+			copy->findFirst(vectors[0], n, tol);
+			timer.resume();
+
+			while (copy->getSize() != 0) {
+				copy->remove(0);
+			}
+
+			timer.pause();
+			delete copy;
+			timer.resume();
+		});
+
+		delete set;
+	}
+
+	/*
+	 * Operations over sets without own index, sharing half of their vectors
+	 */
+	void runAlgebraBenchmarks(Benchmark::Runner& runner, const std::vector<IVector*>& vectors,
+							  const Benchmark::Params& params) {
+		auto n = IVector::NORM::SECOND;
+		double tol = 1.0e-6;
+		size_t size = vectors.size();
+		size_t dim = vectors[0]->getDim();
+
+		auto createSet = [&](size_t begin, size_t end) {
+			std::vector<double> block;
+			for (size_t i = begin; i < end; i++) {
+				block.insert(block.end(), vectors[i]->getData(), vectors[i]->getData() + dim);
+			}
+
+			ISet* set = ISet::createSet();
+			set->insertMany(end - begin, dim, block.data(), n, tol);
+			return set;
+		};
+
+		ISet* op1 = createSet(0, size * 3 / 4);
+		ISet* op2 = createSet(size / 4, size);
+		ISet* same = op1->clone();
+
+		auto runOperation = [&](const std::string& name, ISet* (*operation)(ISet const* const&, ISet const* const&,
+																			 IVector::NORM, double)) {
+			runner.run("Set/algebra/" + name, params, size, [&](Benchmark::Timer& timer) {
+				ISet* result = operation(op1, op2, n, tol);
+
+				timer.pause();
+				Benchmark::consume(static_cast<double>(result->getSize()));
+				delete result;
+				timer.resume();
+			});
+		};
+
+		runOperation("intersection", ISet::makeIntersection);
+		runOperation("union", ISet::makeUnion);
+		runOperation("sub", ISet::sub);
+		runOperation("symSub", ISet::symSub);
+
+		// Equal sets can't stop early
+		runner.run("Set/algebra/equals", params, size, [&](Benchmark::Timer&) {
+			Benchmark::consume(ISet::equals(op1, same, n, tol));
+		});
+		runner.run("Set/algebra/subSet", params, size, [&](Benchmark::Timer&) {
+			Benchmark::consume(ISet::subSet(op1, same, n, tol));
+		});
+
+		delete op1;
+		delete op2;
+		delete same;
+	}
+
+} // namespace
+
+void Benchmarks::setBenchmark(Benchmark::Runner& runner, ILogger* logger) {
+	ISet::setLogger(logger);
+
+	std::mt19937 generator(42);
+
+	size_t dim = 8;
+
+	for (size_t size : { 100, 1000 }) {
+		Benchmark::Params params = { { "dim", dim }, { "size", size } };
+
+		std::vector<IVector*> vectors = randomVectors(size, dim, generator);
+
+		// Every insert searches for a duplicate, so without index filling the set is quadratic in its size
+		runSetBenchmarks(runner, "Set/", ISet::INDEX::NONE, vectors, params);
+		runSetBenchmarks(runner, "Set/hashGrid/", ISet::INDEX::HASH_GRID, vectors, params);
+		runSetBenchmarks(runner, "Set/kdTree/", ISet::INDEX::KD_TREE, vectors, params);
+		runAlgebraBenchmarks(runner, vectors, params);
+
+		for (auto vec : vectors) {
+			delete vec;
+		}
+	}
+
+	// Sizes out of reach for linear scan
+	for (size_t largeDim : { 8, 32 }) {
+		size_t size = 10000;
+		Benchmark::Params params = { { "dim", largeDim }, { "size", size } };
+
+		std::vector<IVector*> vectors = randomVectors(size, largeDim, generator);
+		runSetBenchmarks(runner, "Set/hashGrid/", ISet::INDEX::HASH_GRID, vectors, params);
+		runSetBenchmarks(runner, "Set/kdTree/", ISet::INDEX::KD_TREE, vectors, params);
+
+		for (auto vec : vectors) {
+			delete vec;
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#include <vector>
+
+#include <IDiffProblem.h>
+#include <ISolver.h>
+
+#include "Benchmarks.h"
+#include "DllLoader.h"
+
+void Benchmarks::solverBenchmark(Benchmark::Runner& runner, ILogger* logger) {
+	DllLoader problemLoader;
+	DllLoader solverLoader;
+	if (!problemLoader.loadLibrary("libProblem") || !solverLoader.loadLibrary("libSolver")) {
+		return;
+	}
+	auto problem = reinterpret_cast<IDiffProblem*>(problemLoader.loadImplementation(IBroker::INTERFACE_IMPL::IPROBLEM));
+	auto solver = reinterpret_cast<ISolver*>(solverLoader.loadImplementation(IBroker::INTERFACE_IMPL::ISOLVER));
+
+	// Same setup as in tests, solveByArgs runs splitStepMethod
+	size_t argDim = 2;
+	size_t paramDim = 4;
+
+	ICompact* argsDomain = createDomain(argDim, 20, 100);
+	ICompact* paramsDomain = createDomain(paramDim, 10, 50);
+
+	problem->setArgsDomain(argsDomain, logger);
+	problem->setParamsDomain(paramsDomain);
+
+	IVector* paramPoint = IVector::createVector(paramDim, std::vector<double>{ 3, 2, -1, 4 }.data());
+	problem->setParams(paramPoint);
+
+	solver->setProblem(problem);
+	solver->setArgsDomain(argsDomain, logger);
+	solver->setParamsDomain(paramsDomain);
+
+	IVector* solverParams = IVector::createVector(4, std::vector<double>{ 1.0e-6, 0.9, 0.5, 0.5 }.data());
+	IVector* startPoint = IVector::createVector(argDim, std::vector<double>{ -0.5, -2.0 }.data());
+
+	Benchmark::Params params = { { "dim", argDim } };
+
+	runner.run("Solver/splitStepMethod", params, 1, [&](Benchmark::Timer& timer) {
+		solver->solveByArgs(startPoint, solverParams);
+
+		timer.pause();
+		IVector* solution = nullptr;
+		solver->getSolution(solution);
+		Benchmark::consume(solution ? solution->getData()[0] : 0);
+		delete solution;
+		timer.resume();
+	});
+
+	delete startPoint;
+	delete solverParams;
+	delete paramPoint;
+	delete argsDomain;
+	delete paramsDomain;
+	delete problem;
+	delete solver;
+}
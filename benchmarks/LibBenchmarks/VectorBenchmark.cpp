@@ -0,0 +1,67 @@
+#include <random>
+#include <vector>
+
+#include <IVector.h>
+
+#include "Benchmarks.h"
+
+namespace {
+
+	std::vector<double> randomData(size_t dim, std::mt19937& generator) {
+		std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+		std::vector<double> data(dim);
+		for (auto& value : data) {
+			value = distribution(generator);
+		}
+		return data;
+	}
+
+} // namespace
+
+void Benchmarks::vectorBenchmark(Benchmark::Runner& runner, ILogger* logger) {
+	IVector::setLogger(logger);
+
+	std::mt19937 generator(42);
+
+	for (size_t dim : { 4, 64, 1024, 65536, 1048576 }) {
+		Benchmark::Params params = { { "dim", dim } };
+
+		std::vector<double> data = randomData(dim, generator);
+		std::vector<double> otherData = randomData(dim, generator);
+
+		runner.run("Vector/createVector", params, 1, [&](Benchmark::Timer&) {
+			IVector* vec = IVector::createVector(dim, data.data());
+			Benchmark::consume(vec->getData()[0]);
+			delete vec;
+		});
+
+		IVector* vec = IVector::createVector(dim, data.data());
+		IVector* other = IVector::createVector(dim, otherData.data());
+
+		runner.run("Vector/clone", params, 1, [&](Benchmark::Timer&) {
+			IVector* copy = vec->clone();
+			Benchmark::consume(copy->getData()[0]);
+			delete copy;
+		});
+
+		runner.run("Vector/dot", params, 1, [&](Benchmark::Timer&) {
+			Benchmark::consume(IVector::dot(vec, other));
+		});
+
+		runner.run("Vector/norm/first", params, 1, [&](Benchmark::Timer&) {
+			Benchmark::consume(vec->norm(IVector::NORM::FIRST));
+		});
+
+		runner.run("Vector/norm/second", params, 1, [&](Benchmark::Timer&) {
+			Benchmark::consume(vec->norm(IVector::NORM::SECOND));
+		});
+
+		runner.run("Vector/norm/chebyshev", params, 1, [&](Benchmark::Timer&) {
+			Benchmark::consume(vec->norm(IVector::NORM::CHEBYSHEV));
+		});
+
+		delete vec;
+		delete other;
+	}
+}
@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <ILogger.h>
+#include <IVector.h>
+
+#include "Benchmark.h"
+#include "LibBenchmarks/Benchmarks.h"
+
+namespace {
+
+	void printUsage(const char* name) {
+		std::cout << "Usage: " << name << " [options]\n"
+				  << "  --filter <text>      run only benchmarks with id containing text\n"
+				  << "  --min-time <sec>     measured time per benchmark, 0.5 by default\n"
+				  << "  --json <file>        write results as JSON\n"
+				  << "  --compare <file>     compare results with JSON of a previous run\n"
+				  << "  --threshold <ratio>  slowdown reported as regression, 0.1 by default\n"
+				  << "Exit code is 1 if compare found regressions" << std::endl;
+	}
+
+	const char* getInstructionSetName(IVector::INSTRUCTION_SET set) {
+		switch (set) {
+		case IVector::INSTRUCTION_SET::SCALAR:
+			return "SCALAR";
+		case IVector::INSTRUCTION_SET::SSE2:
+			return "SSE2";
+		case IVector::INSTRUCTION_SET::AVX2:
+			return "AVX2";
+		case IVector::INSTRUCTION_SET::AVX512:
+			return "AVX512";
+		default:
+			return "UNKNOWN";
+		}
+	}
+
+	const char* getSummationName(IVector::SUMMATION summation) {
+		return summation == IVector::SUMMATION::COMPENSATED ? "COMPENSATED" : "PAIRWISE";
+	}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::string filter;
+	std::string jsonPath;
+	std::string baselinePath;
+	double minTime = 0.5;
+	double threshold = 0.1;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+
+		if (!strcmp(argv[i], "--filter") && hasValue) {
+			filter = argv[++i];
+		} else if (!strcmp(argv[i], "--min-time") && hasValue) {
+			minTime = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "--json") && hasValue) {
+			jsonPath = argv[++i];
+		} else if (!strcmp(argv[i], "--compare") && hasValue) {
+			baselinePath = argv[++i];
+		} else if (!strcmp(argv[i], "--threshold") && hasValue) {
+			threshold = atof(argv[++i]);
+		} else {
+			printUsage(argv[0]);
+			return 2;
+		}
+	}
+
+	std::ifstream baseline;
+	if (!baselinePath.empty()) {
+		baseline.open(baselinePath);
+		if (!baseline) {
+			std::cerr << "Can't open " << baselinePath << std::endl;
+			return 2;
+		}
+	}
+
+	ILogger* logger = ILogger::createLogger("BenchmarkLog.txt");
+
+	std::string buildType = BENCHMARK_BUILD_TYPE;
+	if (buildType.empty() || buildType == "Debug") {
+		std::cout << "Warning: benchmarks are built without optimizations, configure with "
+				  << "-DCMAKE_BUILD_TYPE=Release\n" << std::endl;
+	}
+
+	Benchmark::Runner runner(minTime, filter, std::cout);
+	runner.addContext("build_type", buildType.empty() ? "None" : buildType);
+	runner.addContext("instruction_set", getInstructionSetName(IVector::getInstructionSet()));
+	runner.addContext("max_threads", std::to_string(IVector::getMaxThreads()));
+	runner.addContext("summation", getSummationName(IVector::getSummation()));
+
+	Benchmarks::vectorBenchmark(runner, logger);
+	Benchmarks::setBenchmark(runner, logger);
+	Benchmarks::compactBenchmark(runner, logger);
+	Benchmarks::problemBenchmark(runner, logger);
+	Benchmarks::solverBenchmark(runner, logger);
+
+	if (!jsonPath.empty()) {
+		std::ofstream json(jsonPath);
+		runner.printJson(json);
+		if (!json) {
+			std::cerr << "Can't write " << jsonPath << std::endl;
+			return 2;
+		}
+	}
+
+	size_t regressions = 0;
+	if (!baselinePath.empty()) {
+		std::cout << std::endl;
+		regressions = runner.compare(baseline, threshold, std::cout);
+		std::cout << regressions << " regression(s) over " << threshold * 100 << "% threshold" << std::endl;
+	}
+
+	return regressions ? 1 : 0;
+}
@@ -10,8 +10,52 @@ public:
     static ILogger* getLogger();
 
     static ISet* createSet();
+    /*
+     * FLOAT sets store coordinates as float, vectors returned by getCopy and iterators are FLOAT too
+     */
+    static ISet* createSet(IVector::PRECISION precision);
     virtual ISet* clone() const = 0;
 
+    /*
+     * Search structure kept by a set to speed up findFirst, insert and remove by pattern.
+     * HASH_GRID buckets vectors by cells of size tol, so lookups are expected O(1) while tol is small
+     * compared to distances between vectors. It is rebuilt when a different tol is queried.
+     * KD_TREE doesn't depend on tol and keeps O(log n) lookups in higher dimensions, where the grid
+     * can't separate vectors by its few hashed coordinates
+     */
+    enum class INDEX {
+        NONE,
+        HASH_GRID,
+        KD_TREE,
+        AMOUNT
+    };
+
+    /*
+     * Index is built lazily by the first lookup, clones keep the index type only. Const lookups
+     * (findFirst and the find/copy methods) may build the index, and a HASH_GRID lookup with a new tol
+     * rebuilds it in O(n). So concurrent const calls on one set are not safe while it has an index,
+     * unless it was already built for the tol in use
+     */
+    virtual RC setIndex(INDEX index) = 0;
+    virtual INDEX getIndex() const = 0;
+
+    /*
+     * Removed vectors are only marked and storage is compacted once they make up more than ratio
+     * of stored ones, 0.5 by default. Ratio 0 compacts on every removal, ratio has to be less than 1
+     */
+    virtual RC setGarbageRatio(double ratio) = 0;
+    virtual double getGarbageRatio() const = 0;
+
+    /*
+     * Operations search vectors of one operand in the other through its index or a temporary k-d tree,
+     * so for operands of n and m vectors they take O((n + m) log(n + m)) instead of comparing every pair.
+     * Results other than intersection are built from a clone of op1 and keep its precision and index type.
+     *
+     * Vector matches when it is within tol of any vector of the other operand: sub removes every matched
+     * vector of op1 and symSub keeps the unmatched vectors of both operands. So a vector of op2 may remove
+     * several vectors of op1, if they were inserted with a smaller tol, and the result doesn't depend on
+     * the order of vectors
+     */
     static ISet* makeIntersection(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
     static ISet* makeUnion(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
     static ISet* sub(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
@@ -38,6 +82,15 @@ public:
 
     virtual RC insert(IVector const * const& val, IVector::NORM n, double tol) = 0;
 
+    /*
+     * Inserts count vectors of dim coordinates stored one after another with the same result as inserting
+     * them in order one by one: vector equal to one in the set or to an earlier inserted one of the block
+     * is VECTOR_ALREADY_EXIST. Status of every vector is written to statuses unless it is nullptr.
+     * Returns the first error of a vector other than VECTOR_ALREADY_EXIST, the rest are still inserted
+     */
+    virtual RC insertMany(size_t count, size_t dim, double const* coords, IVector::NORM n, double tol,
+                          RC* statuses = nullptr) = 0;
+
     virtual RC remove(size_t index) = 0;
     virtual RC remove(IVector const * const& pat, IVector::NORM n, double tol) = 0;
 
@@ -14,8 +14,52 @@ public:
         AMOUNT
     };
 
+    /*
+     * Instruction sets used by the vector kernels, the best one supported by CPU is chosen
+     * when the library is loaded
+     */
+    enum class INSTRUCTION_SET {
+        SCALAR,
+        SSE2,
+        AVX2,
+        AVX512,
+        AMOUNT
+    };
+
+    /*
+     * Storage type of coordinates. FLOAT vectors halve memory footprint, reductions over them are still
+     * accumulated in double
+     */
+    enum class PRECISION {
+        DOUBLE,
+        FLOAT,
+        AMOUNT
+    };
+
     static IVector* createVector(size_t dim, double const* const& ptr_data);
+    static IVector* createVector(size_t dim, double const* const& ptr_data, PRECISION precision);
+    // Creates FLOAT vector without conversion
+    static IVector* createVector(size_t dim, float const* const& ptr_data);
+
+    /*
+     * Sparse vectors store only nonzero coordinates as index/value pairs sorted by index. dot, norms and
+     * updates by a sparse operand cost O(nnz). getData of a sparse vector fills a dense mirror.
+     * Indices must be strictly increasing, zero values are dropped
+     */
+    static IVector* createSparseVector(size_t dim, double const* const& ptr_data);
+    static IVector* createSparseVector(size_t dim, size_t nnz, size_t const* indices, double const* values);
+    /*
+     * Creates vector working directly on external memory: nothing is copied and the buffer isn't freed
+     * with the view. Buffer must outlive the view, values written to it directly are not validated.
+     * Clone of a view owns its coordinates
+     */
+    static IVector* createView(size_t dim, double* const& ptr_data);
     static RC copyInstance(IVector* const dest, IVector const* const& src);
+    /*
+     * Hands coordinates of src over to dest and deletes src. Takes O(1) when both vectors are of the
+     * same kind and keep coordinates in a separate block (large dense vectors, sparse vectors),
+     * otherwise coordinates are copied
+     */
     static RC moveInstance(IVector* const dest, IVector*& src);
 
     virtual IVector* clone() const = 0;
@@ -23,27 +67,198 @@ public:
     // Dim needs for double check that ptr_data have the same size as dimension of vector
     virtual RC setData(size_t dim, double const* const& ptr_data) = 0;
 
+    virtual PRECISION getPrecision() const = 0;
+    /*
+     * Native coordinates of FLOAT vectors, nullptr for DOUBLE ones. FLOAT vectors keep no double
+     * coordinates, their getData returns nullptr, they are read by getFloatData, getCoord or foreach
+     */
+    virtual float const* getFloatData() const = 0;
+
+    // Number of stored coordinates, equals dim for dense vectors
+    virtual size_t getNonZeroCount() const = 0;
+    // Stored index/value pairs of sparse vectors, nullptr for dense ones
+    virtual size_t const* getNonZeroIndices() const = 0;
+    virtual double const* getNonZeroValues() const = 0;
+
     static RC setLogger(ILogger* const logger);
     static ILogger* getLogger();
 
+    /*
+     * Returns INVALID_ARGUMENT if kernels for the set were not compiled in or CPU doesn't support them
+     */
+    static RC setInstructionSet(INSTRUCTION_SET set);
+    static INSTRUCTION_SET getInstructionSet();
+    static bool isInstructionSetSupported(INSTRUCTION_SET set);
+
+    /*
+     * Accumulation used by dot and FIRST and SECOND norms
+     */
+    enum class SUMMATION {
+        PAIRWISE, // Vectorized sums of short blocks added as a balanced tree, error grows as log of dimension
+        COMPENSATED, // Neumaier summation term by term, slower but error doesn't grow with dimension
+        AMOUNT
+    };
+
+    static RC setSummation(SUMMATION mode);
+    static SUMMATION getSummation();
+
+    /*
+     * Reductions and elementwise updates of vectors with at least threshold coordinates are split
+     * into fixed-size chunks processed by a shared thread pool. Partial results are combined in chunk
+     * order, so they don't depend on the number of threads
+     */
+    static RC setParallelThreshold(size_t dim);
+    static size_t getParallelThreshold();
+
+    /*
+     * Caps threads used by a single operation, including the calling one. 1 keeps all work on the calling thread
+     */
+    static RC setMaxThreads(size_t count);
+    static size_t getMaxThreads();
+
+    /*
+     * Vectors are allocated from size-class free lists cached per thread
+     */
+    struct PoolStatistics {
+        size_t hits; // Allocations served from cached memory
+        size_t misses; // Allocations that went to system allocator
+        size_t bytesRetained; // Freed memory kept for reuse
+    };
+
+    static PoolStatistics getPoolStatistics();
+
+    /*
+     * Returns memory cached by the calling thread and by the shared pool to the system. Other threads
+     * return their caches on their next allocation or deallocation, or when they exit
+     */
+    static RC trimPool();
+
+    /*
+     * Limits memory kept by the shared pool, 0 disables caching of freed vectors
+     */
+    static RC setPoolRetentionLimit(size_t bytes);
+
+    /*
+     * Operations counted by operation counters. Operations used internally by other ones are counted
+     * too, e.g. clone also counts CREATE
+     */
+    enum class OPERATION {
+        CREATE, // createVector, createView, createSparseVector
+        CLONE,
+        SET_DATA,
+        COPY, // copyInstance
+        MOVE, // moveInstance
+        ADD,
+        SUB,
+        UPDATE, // inc, dec, axpy and axpby
+        SCALE,
+        LINEAR_COMBINATION,
+        DOT,
+        NORM,
+        EQUALS,
+        APPLY, // applyFunction and applyBlockFunction
+        FOREACH, // foreach and foreachBlock
+        AMOUNT
+    };
+
+    struct OperationCounters {
+        size_t calls[static_cast<size_t>(OPERATION::AMOUNT)];
+        size_t coordinates[static_cast<size_t>(OPERATION::AMOUNT)]; // Coordinates processed by the calls
+        size_t allocations;
+        size_t bytesAllocated;
+    };
+
+    /*
+     * Counters are off by default, enabled they cost a relaxed atomic increment per call. Library built
+     * without VECTOR_COUNTERS has no counting code at all and can't enable them
+     */
+    static RC setCountersEnabled(bool enabled);
+    static bool isCountersEnabled();
+    static OperationCounters getOperationCounters();
+    static RC resetOperationCounters();
+
 	virtual RC getCoord(size_t index, double& val) const = 0;
 	virtual RC setCoord(size_t index, double val) = 0;
+
+    /*
+     * Updates below and applyFunction/applyBlockFunction never store NaN or infinity. The span holding
+     * the first bad result keeps its old values and NOT_NUMBER or INFINITY_OVERFLOW is returned,
+     * other coordinates may already hold new values then
+     */
     virtual RC scale(double multiplier) = 0;
     virtual size_t getDim() const = 0;
 
     virtual RC inc(IVector const* const& op) = 0;
     virtual RC dec(IVector const* const& op) = 0;
 
+    /*
+     * Fused in-place updates, each of them makes a single pass over memory
+     *
+     * axpy: this = this + alpha * op
+     * axpby: this = alpha * op + beta * this
+     * linearCombination: this = sum of coeffs[i] * ops[i] for i < count, this may be one of ops
+     */
+    virtual RC axpy(double alpha, IVector const* const& op) = 0;
+    virtual RC axpby(double alpha, IVector const* const& op, double beta) = 0;
+    virtual RC linearCombination(size_t count, double const* coeffs, IVector const* const* ops) = 0;
+
     static IVector* add(IVector const* const& op1, IVector const* const& op2);
     static IVector* sub(IVector const* const& op1, IVector const* const& op2);
 
+    /*
+     * Same as above but result is written into existing vector, dest may be one of operands
+     */
+    static RC add(IVector const* const& op1, IVector const* const& op2, IVector* const& dest);
+    static RC sub(IVector const* const& op1, IVector const* const& op2, IVector* const& dest);
+
     static double dot(IVector const* const& op1, IVector const* const& op2);
     static bool equals(IVector const* const& op1, IVector const* const& op2, NORM n, double tol);
+
+    /*
+     * Same as equals for coordinates kept outside of vectors, e.g. rows of a container.
+     * Nothing is allocated and comparison stops as soon as partial distance reaches tol
+     */
+    static bool equals(double const* data1, double const* data2, size_t dim, NORM n, double tol);
+
     virtual double norm(NORM n) const = 0;
 
+    /*
+     * Coordinates are visited in increasing index order
+     */
     virtual RC applyFunction(const std::function<double(double)>& fun) = 0;
     virtual RC foreach(const std::function<void(double)>& fun) const = 0;
 
+    /*
+     * Block variants: fun is called on consecutive spans of coordinates in increasing index order,
+     * so it can be a vectorized math routine. in and out of applyBlockFunction point to the same span
+     */
+    using BlockFunction = std::function<void(const double* in, double* out, size_t n)>;
+    using ConstBlockFunction = std::function<void(const double* in, size_t n)>;
+
+    virtual RC applyBlockFunction(const BlockFunction& fun) = 0;
+    virtual RC foreachBlock(const ConstBlockFunction& fun) const = 0;
+
+    /*
+     * Elementwise helpers over the block variants, fun is inlined into the loop over each span
+     */
+    template<class Function>
+    RC applyInline(Function fun) {
+        return applyBlockFunction([&fun](const double* in, double* out, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                out[i] = fun(in[i]);
+            }
+        });
+    }
+
+    template<class Function>
+    RC foreachInline(Function fun) const {
+        return foreachBlock([&fun](const double* in, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                fun(in[i]);
+            }
+        });
+    }
+
     virtual size_t sizeAllocated() const = 0;
 
     virtual ~IVector() = 0;
@@ -54,4 +269,10 @@ private:
 
 protected:
 	IVector() = default;
+
+	/*
+	 * Exchanges coordinate storage with other vector in O(1), returns false if storages are not
+	 * exchangeable: other is of a different kind or dim, or one of vectors keeps coordinates inline
+	 */
+	virtual bool swapStorage(IVector* other) = 0;
 };
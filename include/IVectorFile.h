@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include "IVector.h"
+#include "RC.h"
+#include "Interfacedllexport.h"
+
+/*
+ * Binary file of double vectors, loaded by mapping it into memory without parsing or copying
+ *
+ * Layout, native byte order:
+ *     64 byte header: magic "IVECTORS", uint32 version, uint32 byte order mark 0x01020304, uint64 count
+ *     count records: uint64 dim followed by dim doubles starting on a 64 byte boundary
+ * Records are padded so that coordinates of every vector are aligned the same way as in IVector.
+ * Errors are logged to IVector logger
+ */
+class LIB_EXPORT IVectorFile {
+public:
+    static const unsigned VERSION = 1;
+
+    /*
+     * Maps file for reading, nullptr if it can't be opened or is not a valid file of this VERSION
+     */
+    static IVectorFile* load(char const* const& path);
+
+    /*
+     * Writes count vectors into a new file, replacing existing one
+     */
+    static RC save(char const* const& path, size_t count, IVector const* const* vectors);
+
+    virtual size_t getCount() const = 0;
+
+    /*
+     * View over mapped coordinates valid while this object is alive, nullptr for index out of range.
+     * Mapping is read only, coordinates are not validated on load
+     */
+    virtual IVector const* getVector(size_t index) const = 0;
+
+    /*
+     * Streaming writer, vectors are written one by one as they come. Header is completed on flush
+     * and on destruction, so file written by writer that wasn't flushed is seen with fewer vectors
+     */
+    class LIB_EXPORT IWriter {
+    public:
+        virtual RC append(IVector const* const& vector) = 0;
+        virtual size_t getCount() const = 0;
+        virtual RC flush() = 0;
+
+        virtual ~IWriter() = 0;
+
+    private:
+        IWriter(const IWriter&) = delete;
+        IWriter& operator=(const IWriter&) = delete;
+
+    protected:
+        IWriter() = default;
+    };
+
+    /*
+     * With append new vectors are added after the ones already stored in existing file, missing file
+     * is created. Existing file that is not valid is never overwritten in this mode
+     */
+    static IWriter* createWriter(char const* const& path, bool append = false);
+
+    virtual ~IVectorFile() = 0;
+
+private:
+    IVectorFile(const IVectorFile&) = delete;
+    IVectorFile& operator=(const IVectorFile&) = delete;
+
+protected:
+    IVectorFile() = default;
+};
@@ -0,0 +1,289 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include "IVector.h"
+
+/*
+ * Lazy elementwise arithmetic over IVector
+ *
+ * Expression is only a tree of references to operands, nothing is computed until it is assigned
+ * to a vector or reduced, both done in a single loop without temporary vectors:
+ *
+ *     using namespace VectorExpression;
+ *     assign(dest, expr(a) + expr(b) - 2.0 * expr(c));
+ *     double n = norm(expr(a) - expr(b), IVector::NORM::SECOND);
+ *
+ * Operands must outlive the expression and must not be modified while it is alive, except by assign.
+ * dest of assign may be one of operands
+ */
+namespace VectorExpression {
+
+    template<class Derived>
+    class Expression {
+    public:
+        const Derived& derived() const { return static_cast<const Derived&>(*this); }
+    };
+
+    class Operand : public Expression<Operand> {
+    public:
+        // Float vectors are read natively, sparse ones fill their dense mirror in getData, which may fail
+        explicit Operand(IVector const* vector)
+            : m_floatData(vector ? vector->getFloatData() : nullptr),
+              m_data(vector && !m_floatData ? vector->getData() : nullptr), m_dim(vector ? vector->getDim() : 0),
+              m_status(!vector ? RC::NULLPTR_ERROR
+                               : !m_data && !m_floatData ? RC::ALLOCATION_ERROR : RC::SUCCESS) {}
+
+        double operator[](size_t i) const { return m_floatData ? m_floatData[i] : m_data[i]; }
+        size_t getDim() const { return m_dim; }
+        RC getStatus() const { return m_status; }
+
+    private:
+        float const* m_floatData;
+        double const* m_data;
+        size_t m_dim;
+        RC m_status;
+    };
+
+    template<class E>
+    class Scaled : public Expression<Scaled<E>> {
+    public:
+        Scaled(double alpha, const E& e) : m_alpha(alpha), m_e(e) {}
+
+        double operator[](size_t i) const { return m_alpha * m_e[i]; }
+        size_t getDim() const { return m_e.getDim(); }
+        RC getStatus() const { return m_e.getStatus(); }
+
+    private:
+        double m_alpha;
+        E m_e;
+    };
+
+    struct Plus {
+        static double apply(double x, double y) { return x + y; }
+    };
+
+    struct Minus {
+        static double apply(double x, double y) { return x - y; }
+    };
+
+    struct Multiplies {
+        static double apply(double x, double y) { return x * y; }
+    };
+
+    template<class L, class R, class Op>
+    class Binary : public Expression<Binary<L, R, Op>> {
+    public:
+        Binary(const L& l, const R& r) : m_l(l), m_r(r) {}
+
+        double operator[](size_t i) const { return Op::apply(m_l[i], m_r[i]); }
+        size_t getDim() const { return m_l.getDim(); }
+
+        RC getStatus() const {
+            if (m_l.getStatus() != RC::SUCCESS) {
+                return m_l.getStatus();
+            }
+            if (m_r.getStatus() != RC::SUCCESS) {
+                return m_r.getStatus();
+            }
+            return m_l.getDim() == m_r.getDim() ? RC::SUCCESS : RC::MISMATCHING_DIMENSIONS;
+        }
+
+    private:
+        L m_l;
+        R m_r;
+    };
+
+    inline Operand expr(IVector const* vector) { return Operand(vector); }
+
+    template<class L, class R>
+    Binary<L, R, Plus> operator+(const Expression<L>& l, const Expression<R>& r) {
+        return Binary<L, R, Plus>(l.derived(), r.derived());
+    }
+
+    template<class L, class R>
+    Binary<L, R, Minus> operator-(const Expression<L>& l, const Expression<R>& r) {
+        return Binary<L, R, Minus>(l.derived(), r.derived());
+    }
+
+    /*
+     * Elementwise product
+     */
+    template<class L, class R>
+    Binary<L, R, Multiplies> operator*(const Expression<L>& l, const Expression<R>& r) {
+        return Binary<L, R, Multiplies>(l.derived(), r.derived());
+    }
+
+    template<class E>
+    Scaled<E> operator*(double alpha, const Expression<E>& e) {
+        return Scaled<E>(alpha, e.derived());
+    }
+
+    template<class E>
+    Scaled<E> operator*(const Expression<E>& e, double alpha) {
+        return Scaled<E>(alpha, e.derived());
+    }
+
+    template<class E>
+    Scaled<E> operator-(const Expression<E>& e) {
+        return Scaled<E>(-1.0, e.derived());
+    }
+
+    namespace Details {
+
+        inline RC report(RC code, const char* file, const char* function, int line) {
+            ILogger* logger = IVector::getLogger();
+            if (logger) {
+                logger->warning(code, file, function, line);
+            }
+            return code;
+        }
+
+        /*
+         * Sum of term(i) over [begin, begin + n) as IVector reductions do it in PAIRWISE mode: blocks of
+         * BLOCK_SIZE terms added as a balanced tree
+         */
+        const size_t BLOCK_SIZE = 256;
+
+        template<class Term>
+        double pairwise(size_t begin, size_t n, const Term& term) {
+            if (n <= BLOCK_SIZE) {
+                double sum = 0;
+                for (size_t i = begin; i < begin + n; i++) {
+                    sum += term(i);
+                }
+                return sum;
+            }
+
+            size_t half = (n / BLOCK_SIZE + 1) / 2 * BLOCK_SIZE;
+            return pairwise(begin, half, term) + pairwise(begin + half, n - half, term);
+        }
+
+        /*
+         * Sum of n terms in the mode of IVector::getSummation, COMPENSATED one uses Neumaier correction
+         */
+        template<class Term>
+        double sum(size_t n, const Term& term) {
+            if (IVector::getSummation() != IVector::SUMMATION::COMPENSATED) {
+                return pairwise(0, n, term);
+            }
+
+            double sum = 0;
+            double compensation = 0;
+            for (size_t i = 0; i < n; i++) {
+                double value = term(i);
+                double next = sum + value;
+                if (std::fabs(sum) >= std::fabs(value)) {
+                    compensation += (sum - next) + value;
+                } else {
+                    compensation += (value - next) + sum;
+                }
+                sum = next;
+            }
+
+            // Correction of overflowed sum is NaN, infinity is kept as is
+            return std::isfinite(sum) ? sum + compensation : sum;
+        }
+
+    } // namespace Details
+
+// Logs location inside assign, norm or dot that detected the failure, not the caller's one.
+// Undefined at the end of the header
+#define VECTOR_EXPRESSION_REPORT(code) Details::report(code, __FILE__, __func__, __LINE__)
+
+    /*
+     * dest = expression, result is validated by dest the same way as by applyBlockFunction
+     */
+    template<class E>
+    RC assign(IVector* const& dest, const Expression<E>& expression) {
+        const E& e = expression.derived();
+
+        if (!dest) {
+            return VECTOR_EXPRESSION_REPORT(RC::NULLPTR_ERROR);
+        }
+        if (e.getStatus() != RC::SUCCESS) {
+            return VECTOR_EXPRESSION_REPORT(e.getStatus());
+        }
+        if (dest->getDim() != e.getDim()) {
+            return VECTOR_EXPRESSION_REPORT(RC::MISMATCHING_DIMENSIONS);
+        }
+
+        // Blocks come in order and each coordinate is read before being overwritten
+        size_t offset = 0;
+        return dest->applyBlockFunction([&e, &offset](const double*, double* out, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                out[i] = e[offset + i];
+            }
+            offset += n;
+        });
+    }
+
+    /*
+     * Same semantic as IVector::norm, NaN for invalid expression
+     */
+    template<class E>
+    double norm(const Expression<E>& expression, IVector::NORM n) {
+        const E& e = expression.derived();
+        if (e.getStatus() != RC::SUCCESS) {
+            VECTOR_EXPRESSION_REPORT(e.getStatus());
+            return NAN;
+        }
+
+        double res = 0;
+        size_t dim = e.getDim();
+
+        switch (n) {
+        case IVector::NORM::FIRST:
+            res = Details::sum(dim, [&e](size_t i) { return std::fabs(e[i]); });
+            break;
+
+        case IVector::NORM::SECOND:
+            res = std::sqrt(Details::sum(dim, [&e](size_t i) {
+                double value = e[i];
+                return value * value;
+            }));
+            break;
+
+        // Unlike fmax keeps NaN, which also stops the loop, as in IVector::norm
+        case IVector::NORM::CHEBYSHEV:
+            for (size_t i = 0; i < dim && !std::isnan(res); i++) {
+                double value = std::fabs(e[i]);
+                if (!(value <= res)) {
+                    res = value;
+                }
+            }
+            break;
+
+        default:
+            VECTOR_EXPRESSION_REPORT(RC::UNKNOWN);
+            return NAN;
+        }
+
+        if (std::isinf(res)) {
+            VECTOR_EXPRESSION_REPORT(RC::INFINITY_OVERFLOW);
+        }
+        return res;
+    }
+
+    /*
+     * Same semantic as IVector::dot
+     */
+    template<class L, class R>
+    double dot(const Expression<L>& left, const Expression<R>& right) {
+        Binary<L, R, Multiplies> product(left.derived(), right.derived());
+        if (product.getStatus() != RC::SUCCESS) {
+            VECTOR_EXPRESSION_REPORT(product.getStatus());
+            return NAN;
+        }
+
+        double res = Details::sum(product.getDim(), [&product](size_t i) { return product[i]; });
+
+        if (std::isinf(res)) {
+            VECTOR_EXPRESSION_REPORT(RC::INFINITY_OVERFLOW);
+            return NAN;
+        }
+        return res;
+    }
+
+} // namespace VectorExpression
+
+#undef VECTOR_EXPRESSION_REPORT
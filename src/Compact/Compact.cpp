@@ -75,12 +75,13 @@ bool Compact::isInside(IVector const* const& vec) const {
 
 	auto minData = m_minBound->getData();
 	auto maxData = m_maxBound->getData();
-	auto vecData = vec->getData();
 
 	auto isInside = [](double x, double lo, double hi) { return x >= lo && x <= hi; };
 
+	// Coordinates are read one by one, FLOAT vectors have no double ones
 	for (size_t i = 0; i < getDim(); i++) {
-		if (!isInside(vecData[i], minData[i], maxData[i])) {
+		double x;
+		if (vec->getCoord(i, x) != RC::SUCCESS || !isInside(x, minData[i], maxData[i])) {
 			return false;
 		}
 	}
@@ -192,9 +193,14 @@ ICompact* ICompact::createIntersection(ICompact const* op1,
 	op2->getLeftBoundary(def2.minBound);
 	op2->getRightBoundary(def2.maxBound);
 
+	// Bounds of the first operand are temporary copies, so results are written right into them
 	Compact::CompactDef intersectionDef;
-	intersectionDef.minBound = VectorUtils::max(def1.minBound, def2.minBound);
-	intersectionDef.maxBound = VectorUtils::min(def1.maxBound, def2.maxBound);
+	if (VectorUtils::max(def1.minBound, def2.minBound, def1.minBound) == RC::SUCCESS &&
+		VectorUtils::min(def1.maxBound, def2.maxBound, def1.maxBound) == RC::SUCCESS) {
+
+		std::swap(intersectionDef.minBound, def1.minBound);
+		std::swap(intersectionDef.maxBound, def1.maxBound);
+	}
 	intersectionDef.nodeQuantities = grid->clone();
 
 	if (!intersectionDef.isValid() || !applyTolerance(intersectionDef, tol)) {
@@ -232,9 +238,14 @@ ICompact* ICompact::createCompactSpan(ICompact const* op1,
 	op2->getLeftBoundary(def2.minBound);
 	op2->getRightBoundary(def2.maxBound);
 
+	// Bounds of the first operand are temporary copies, so results are written right into them
 	Compact::CompactDef spanDef;
-	spanDef.minBound = VectorUtils::min(def1.minBound, def2.minBound);
-	spanDef.maxBound = VectorUtils::max(def1.maxBound, def2.maxBound);
+	if (VectorUtils::min(def1.minBound, def2.minBound, def1.minBound) == RC::SUCCESS &&
+		VectorUtils::max(def1.maxBound, def2.maxBound, def1.maxBound) == RC::SUCCESS) {
+
+		std::swap(spanDef.minBound, def1.minBound);
+		std::swap(spanDef.maxBound, def1.maxBound);
+	}
 	spanDef.nodeQuantities = grid->clone();
 
 	if (!spanDef.isValid()) {
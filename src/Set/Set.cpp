@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <cstring>
 
 #include "VectorUtils.h"
@@ -14,7 +16,9 @@ ILogger* ISet::getLogger() {
 	return LogContainer<Set>::getInstance();
 }
 
-size_t Set::vecDataSize() const { return m_dim * sizeof(double); }
+size_t Set::vecDataSize() const {
+	return m_dim * (m_precision == IVector::PRECISION::FLOAT ? sizeof(float) : sizeof(double));
+}
 
 size_t Set::getDim() const { return m_dim; }
 
@@ -26,7 +30,17 @@ RC Set::getCopy(size_t index, IVector*& val) const {
 		return RC::INDEX_OUT_OF_BOUND;
 	}
 
-	IVector* vector = IVector::createVector(m_dim, getData(index));
+	return copyRow(m_tombstones.getRow(index), val);
+}
+
+RC Set::copyRow(size_t index, IVector*& val) const {
+	IVector* vector = nullptr;
+	if (m_precision == IVector::PRECISION::FLOAT) {
+		vector = IVector::createVector(m_dim, getFloatData(index));
+	} else {
+		vector = IVector::createVector(m_dim, getData(index));
+	}
+
 	if (!vector) {
 		return RC::ALLOCATION_ERROR;
 	}
@@ -41,26 +55,192 @@ RC Set::findFirst(IVector const* pat, IVector::NORM n, double tol, size_t& index
 		return RC::MISMATCHING_DIMENSIONS;
 	}
 
-	auto vec = VectorUtils::createZeroVec(m_dim);
-	if (!vec) {
+	// FLOAT patterns keep no double coordinates, they are converted once into a buffer of the thread
+	const float* patFloatData = pat->getFloatData();
+	if (patFloatData) {
+		static thread_local std::vector<double> patBuffer;
+		patBuffer.resize(std::max(m_dim, size_t(1)));
+		std::copy(patFloatData, patFloatData + m_dim, patBuffer.begin());
+		return findFirst(patBuffer.data(), n, tol, index);
+	}
+
+	const double* patData = pat->getData();
+	if (!patData) {
 		return RC::ALLOCATION_ERROR;
 	}
 
-	for (size_t i = 0; i < m_size; i++) {
-		vec->setData(m_dim, getData(i));
+	return findFirst(patData, n, tol, index);
+}
+
+RC Set::findFirst(const double* pat, IVector::NORM n, double tol, size_t& index) const {
+	// Reused by lookups of the thread, so that they don't allocate once the buffer has grown
+	static thread_local std::vector<size_t> candidates;
+	candidates.clear();
+	if (getCandidates(pat, tol, candidates)) {
+		return findFirstIn(pat, n, tol, candidates.data(), candidates.size(), index);
+	}
+	return findFirstIn(pat, n, tol, nullptr, m_rowCount, index);
+}
+
+RC Set::findFirstIn(const double* pat, IVector::NORM n, double tol, const size_t* indices, size_t count,
+					size_t& index) const {
+	// Float rows are converted into a buffer of the thread that only grows, so lookups don't allocate
+	static thread_local std::vector<double> buffer;
+	if (m_precision == IVector::PRECISION::FLOAT && buffer.size() < std::max(m_dim, size_t(1))) {
+		buffer.resize(std::max(m_dim, size_t(1)));
+	}
+
+	for (size_t j = 0; j < count; j++) {
+		size_t i = indices ? indices[j] : j;
+		if (!indices && !m_tombstones.isLive(i)) {
+			continue;
+		}
+
+		// Double rows are compared in place
+		const double* row = getData(i);
+		if (m_precision == IVector::PRECISION::FLOAT) {
+			std::copy(getFloatData(i), getFloatData(i) + m_dim, buffer.begin());
+			row = buffer.data();
+		}
 
-		if (IVector::equals(pat, vec, n, tol)) {
+		if (IVector::equals(pat, row, m_dim, n, tol)) {
 			index = i;
-			delete vec;
 			return RC::SUCCESS;
 		}
 	}
-
-	delete vec;
 	return RC::VECTOR_NOT_FOUND;
 }
 
-double* Set::getData(size_t index) const { return m_data + m_dim * index; }
+bool Set::getCandidates(const double* pat, double tol, std::vector<size_t>& indices) const {
+	if (m_index == INDEX::NONE || !(tol > 0) || std::isinf(tol)) {
+		return false;
+	}
+
+	static thread_local std::vector<size_t> keys;
+	keys.clear();
+	if (m_index == INDEX::HASH_GRID) {
+		// Float rows are converted into a buffer of the thread, rebuilds don't allocate once it has grown
+		static thread_local std::vector<double> buffer;
+		if (m_hashGrid.getTol() != tol) {
+			m_hashGrid.reset(m_dim, tol);
+			for (size_t i = 0; i < m_rowCount; i++) {
+				if (m_tombstones.isLive(i)) {
+					m_hashGrid.insert(getData(i, buffer), m_hashArr[i]);
+				}
+			}
+		}
+
+		if (!m_hashGrid.getCandidates(pat, keys)) {
+			return false;
+		}
+	} else {
+		// Tree doesn't depend on tol, it is bulk built once
+		if (!m_kdTree.isBuilt()) {
+			std::vector<SetKdTree::Point> points;
+			points.reserve(m_size);
+			for (size_t i = 0; i < m_rowCount; i++) {
+				if (m_tombstones.isLive(i)) {
+					points.push_back({ m_hashArr[i], getRow(i), SetKdTree::NIL });
+				}
+			}
+			m_kdTree.reset(m_dim, m_precision == IVector::PRECISION::FLOAT);
+			m_kdTree.build(points);
+		}
+
+		m_kdTree.getCandidates(pat, tol, keys);
+	}
+
+	getIndicesByKeys(keys, indices);
+	return true;
+}
+
+void Set::getIndicesByKeys(std::vector<size_t>& keys, std::vector<size_t>& indices) const {
+	// Keys grow with indices, so sorted keys give rows in the order of the linear scan
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+	indices.reserve(keys.size());
+	for (size_t key : keys) {
+		indices.push_back(getIndexByKey(key));
+	}
+}
+
+size_t Set::getIndexByKey(size_t key) const {
+	return std::lower_bound(m_hashArr, m_hashArr + m_rowCount, key) - m_hashArr;
+}
+
+SetKdTree::RowByKey Set::getRowByKey() const {
+	return [this](size_t key) { return getRow(getIndexByKey(key)); };
+}
+
+void Set::indexInsert(size_t index) {
+	if (m_hashGrid.isBuilt()) {
+		// Reused by inserts and removals of the thread, as in getCandidates
+		static thread_local std::vector<double> buffer;
+		m_hashGrid.insert(getData(index, buffer), m_hashArr[index]);
+	}
+	if (m_kdTree.isBuilt()) {
+		m_kdTree.insert(m_hashArr[index], getRow(index), getRowByKey());
+	}
+}
+
+void Set::indexRemove(size_t index) {
+	if (m_hashGrid.isBuilt()) {
+		static thread_local std::vector<double> buffer;
+		m_hashGrid.remove(getData(index, buffer), m_hashArr[index]);
+	}
+	if (m_kdTree.isBuilt()) {
+		m_kdTree.remove(m_hashArr[index], getRowByKey());
+	}
+}
+
+void Set::clearIndex() {
+	m_hashGrid.clear();
+	m_kdTree.clear();
+}
+
+RC Set::setIndex(INDEX index) {
+	if (index != INDEX::NONE && index != INDEX::HASH_GRID && index != INDEX::KD_TREE) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	m_index = index;
+	clearIndex();
+	return RC::SUCCESS;
+}
+
+ISet::INDEX Set::getIndex() const { return m_index; }
+
+RC Set::setGarbageRatio(double ratio) {
+	if (!(ratio >= 0 && ratio < 1)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	m_garbageRatio = ratio;
+	if (m_tombstones.getRemovedCount() > m_garbageRatio * m_rowCount) {
+		compact();
+	}
+	return RC::SUCCESS;
+}
+
+double Set::getGarbageRatio() const { return m_garbageRatio; }
+
+uint8_t* Set::getRow(size_t index) const { return m_data + vecDataSize() * index; }
+
+double* Set::getData(size_t index) const { return reinterpret_cast<double*>(getRow(index)); }
+
+float* Set::getFloatData(size_t index) const { return reinterpret_cast<float*>(getRow(index)); }
+
+const double* Set::getData(size_t index, std::vector<double>& buffer) const {
+	if (m_precision != IVector::PRECISION::FLOAT) {
+		return getData(index);
+	}
+
+	buffer.assign(getFloatData(index), getFloatData(index) + m_dim);
+	return buffer.data();
+}
 
 RC Set::findFirstAndCopy(IVector const* const& pat,
 						 IVector::NORM n,
@@ -72,7 +252,7 @@ RC Set::findFirstAndCopy(IVector const* const& pat,
 		return rc;
 	}
 
-	return getCopy(index, val);
+	return copyRow(index, val);
 }
 
 RC Set::findFirstAndCopyCoords(const IVector* const& pat,
@@ -85,7 +265,7 @@ RC Set::findFirstAndCopyCoords(const IVector* const& pat,
 		return code;
 	}
 
-	return getCoords(index, val);
+	return copyRowCoords(index, val);
 }
 
 RC Set::findFirst(const IVector* const& pat, IVector::NORM n, double tol) const {
@@ -99,19 +279,28 @@ RC Set::getCoords(size_t index, IVector* const& val) const {
 		return RC::INDEX_OUT_OF_BOUND;
 	}
 
+	return copyRowCoords(m_tombstones.getRow(index), val);
+}
+
+RC Set::copyRowCoords(size_t index, IVector* const& val) const {
 	if (val->getDim() != m_dim) {
 		log_warning(RC::MISMATCHING_DIMENSIONS);
 		return RC::MISMATCHING_DIMENSIONS;
 	}
 
-	return val->setData(m_dim, getData(index));
+	std::vector<double> buffer;
+	return val->setData(m_dim, getData(index, buffer));
 }
 
-bool Set::enlarge() {
-	size_t newSize = std::max(size_t(1), m_capacity * 2);
+bool Set::enlarge() { return reserve(std::max(size_t(1), m_capacity * 2)); }
+
+bool Set::reserve(size_t capacity) {
+	if (capacity <= m_capacity) {
+		return true;
+	}
 
-	auto newData = new (std::nothrow) double[newSize * m_dim];
-	auto newHash = new (std::nothrow) size_t[newSize];
+	auto newData = new (std::nothrow) uint8_t[capacity * vecDataSize()];
+	auto newHash = new (std::nothrow) size_t[capacity];
 
 	if (!newData || !newHash) {
 		delete[] newData;
@@ -119,23 +308,49 @@ bool Set::enlarge() {
 		return false;
 	}
 
-	if (m_size != 0) {
-		memcpy(newData, m_data, m_size * vecDataSize());
-		delete[] m_data;
-
-		memcpy(newHash, m_hashArr, m_size * sizeof(size_t));
-		delete[] m_hashArr;
+	if (m_rowCount != 0) {
+		memcpy(newData, m_data, m_rowCount * vecDataSize());
+		memcpy(newHash, m_hashArr, m_rowCount * sizeof(size_t));
 	}
+	delete[] m_data;
+	delete[] m_hashArr;
 
-	m_capacity = newSize;
+	m_capacity = capacity;
 	m_data = newData;
 	m_hashArr = newHash;
 	return true;
 }
 
+RC Set::appendRow(const double* data, const float* floatData) {
+	if (m_precision != IVector::PRECISION::FLOAT && floatData) {
+		std::copy(floatData, floatData + m_dim, getData(m_rowCount));
+	} else if (m_precision != IVector::PRECISION::FLOAT) {
+		memcpy(getData(m_rowCount), data, vecDataSize());
+	} else if (floatData) {
+		memcpy(getFloatData(m_rowCount), floatData, vecDataSize());
+	} else {
+		for (size_t i = 0; i < m_dim; i++) {
+			if (std::fabs(data[i]) > FLT_MAX) {
+				return RC::INFINITY_OVERFLOW;
+			}
+		}
+		std::copy(data, data + m_dim, getFloatData(m_rowCount));
+	}
+	m_hashArr[m_rowCount] = m_topHash;
+	m_topHash++;
+	m_tombstones.append();
+	m_rowCount++;
+	m_size++;
+
+	// Row must be in the set already, tree may read it back while rebalancing
+	indexInsert(m_rowCount - 1);
+	return RC::SUCCESS;
+}
+
 RC Set::insert(IVector const* const& val, IVector::NORM n, double tol) {
 	if (m_size == 0) {
 		m_dim = val->getDim();
+		clearIndex();
 	}
 
 	RC rc = findFirst(val, n, tol);
@@ -147,19 +362,102 @@ RC Set::insert(IVector const* const& val, IVector::NORM n, double tol) {
 		return rc;
 	}
 
-	if (m_size == m_capacity) {
+	if (m_rowCount == m_capacity) {
 		if (!enlarge()) {
 			log_warning(RC::ALLOCATION_ERROR);
 			return RC::ALLOCATION_ERROR;
 		}
 	}
 
-	memcpy(getData(m_size), val->getData(), vecDataSize());
-	m_hashArr[m_size] = m_topHash;
-	m_topHash++;
-	m_size++;
+	// FLOAT vectors give no double coordinates, they are appended from float ones
+	const float* floatData = val->getFloatData();
+	rc = appendRow(floatData ? nullptr : val->getData(), floatData);
+	if (rc != RC::SUCCESS) {
+		log_warning(rc);
+	}
+	return rc;
+}
 
-	return RC::SUCCESS;
+RC Set::insertMany(size_t count, size_t dim, double const* coords, IVector::NORM n, double tol, RC* statuses) {
+	if (!coords && count != 0) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	if (m_size == 0) {
+		m_dim = dim;
+		clearIndex();
+	} else if (dim != m_dim) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	if (!reserve(m_rowCount + count)) {
+		log_warning(RC::ALLOCATION_ERROR);
+		return RC::ALLOCATION_ERROR;
+	}
+
+	bool isGridUsed = m_index == INDEX::NONE && tol > 0 && !std::isinf(tol);
+	SetHashGrid grid;
+	std::vector<double> buffer;
+	if (isGridUsed) {
+		grid.reset(m_dim, tol);
+		for (size_t i = 0; i < m_rowCount; i++) {
+			if (m_tombstones.isLive(i)) {
+				grid.insert(getData(i, buffer), m_hashArr[i]);
+			}
+		}
+	}
+
+	RC result = RC::SUCCESS;
+	std::vector<size_t> keys;
+	std::vector<size_t> candidates;
+	for (size_t i = 0; i < count; i++) {
+		const double* data = coords + i * dim;
+
+		RC rc = RC::SUCCESS;
+		for (size_t j = 0; j < dim && rc == RC::SUCCESS; j++) {
+			if (std::isnan(data[j])) {
+				rc = RC::NOT_NUMBER;
+			} else if (std::isinf(data[j])) {
+				rc = RC::INFINITY_OVERFLOW;
+			}
+		}
+
+		if (rc == RC::SUCCESS) {
+			keys.clear();
+			candidates.clear();
+
+			size_t index;
+			if (isGridUsed && grid.getCandidates(data, keys)) {
+				getIndicesByKeys(keys, candidates);
+				rc = findFirstIn(data, n, tol, candidates.data(), candidates.size(), index);
+			} else {
+				rc = findFirst(data, n, tol, index);
+			}
+
+			if (rc == RC::SUCCESS) {
+				rc = RC::VECTOR_ALREADY_EXIST;
+			} else if (rc == RC::VECTOR_NOT_FOUND) {
+				rc = appendRow(data, nullptr);
+				if (rc == RC::SUCCESS && isGridUsed) {
+					grid.insert(getData(m_rowCount - 1, buffer), m_hashArr[m_rowCount - 1]);
+				}
+			}
+		}
+
+		if (statuses) {
+			statuses[i] = rc;
+		}
+		if (result == RC::SUCCESS && rc != RC::SUCCESS && rc != RC::VECTOR_ALREADY_EXIST) {
+			result = rc;
+		}
+	}
+
+	if (result != RC::SUCCESS) {
+		log_warning(result);
+	}
+	return result;
 }
 
 RC Set::remove(size_t index) {
@@ -168,16 +466,40 @@ RC Set::remove(size_t index) {
 		return RC::INDEX_OUT_OF_BOUND;
 	}
 
-	if (index != m_size - 1) {
-		size_t nextVecNum = m_size - index - 1;
-		memmove(getData(index), getData(index + 1), nextVecNum * vecDataSize());
-		memmove(m_hashArr + index, m_hashArr + index + 1, nextVecNum * sizeof(size_t));
-	}
+	return removeRow(m_tombstones.getRow(index));
+}
+
+RC Set::removeRow(size_t index) {
+	indexRemove(index);
 
+	// Row stays in storage, so removal doesn't move the rows after it
+	m_tombstones.remove(index);
 	m_size--;
+
+	if (m_tombstones.getRemovedCount() > m_garbageRatio * m_rowCount) {
+		compact();
+	}
 	return RC::SUCCESS;
 }
 
+void Set::compact() {
+	size_t live = 0;
+	for (size_t i = 0; i < m_rowCount; i++) {
+		if (!m_tombstones.isLive(i)) {
+			continue;
+		}
+
+		if (live != i) {
+			memcpy(getRow(live), getRow(i), vecDataSize());
+			m_hashArr[live] = m_hashArr[i];
+		}
+		live++;
+	}
+
+	m_rowCount = live;
+	m_tombstones.reset(live);
+}
+
 RC Set::remove(IVector const* const& pat, IVector::NORM n, double tol) {
 	size_t index;
 	RC rc = findFirst(pat, n, tol, index);
@@ -185,7 +507,7 @@ RC Set::remove(IVector const* const& pat, IVector::NORM n, double tol) {
 		return rc;
 	}
 
-	return remove(index);
+	return removeRow(index);
 }
 
 Set::~Set() {
@@ -196,6 +518,165 @@ Set::~Set() {
 
 ISet* ISet::createSet() { return Set::createSet(); }
 
+ISet* ISet::createSet(IVector::PRECISION precision) {
+	if (precision != IVector::PRECISION::DOUBLE && precision != IVector::PRECISION::FLOAT) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return nullptr;
+	}
+
+	return Set::createSet(precision);
+}
+
+namespace {
+
+	// Smaller operands are scanned, building a tree over them costs more than it saves
+	const size_t INDEXED_SIZE = 32;
+
+	/*
+	 * Operand to search vectors in, op itself if it keeps an index or is small, otherwise its clone with
+	 * k-d tree, which doesn't depend on tol. Clone is returned through owned to be deleted by the caller
+	 */
+	ISet const* getIndexed(ISet const* op, ISet*& owned) {
+		owned = nullptr;
+		if (op->getIndex() != ISet::INDEX::NONE || op->getSize() < INDEXED_SIZE) {
+			return op;
+		}
+
+		owned = op->clone();
+		if (!owned || owned->setIndex(ISet::INDEX::KD_TREE) != RC::SUCCESS) {
+			delete owned;
+			owned = nullptr;
+		}
+		return owned;
+	}
+
+	/*
+	 * Splits indices of op vectors by whether lookup has a vector equal to them
+	 */
+	RC match(ISet const* op, ISet const* lookup, IVector::NORM n, double tol, std::vector<size_t>& found,
+			 std::vector<size_t>& missing) {
+		bool isComparable = lookup->getSize() != 0 && lookup->getDim() == op->getDim();
+		if (!isComparable) {
+			for (size_t i = 0; i < op->getSize(); i++) {
+				missing.push_back(i);
+			}
+			return RC::SUCCESS;
+		}
+
+		IVector* vec = VectorUtils::createZeroVec(op->getDim());
+		if (!vec) {
+			return RC::ALLOCATION_ERROR;
+		}
+
+		for (size_t i = 0; i < op->getSize(); i++) {
+			RC rc = op->getCoords(i, vec);
+			if (rc != RC::SUCCESS) {
+				delete vec;
+				return rc;
+			}
+
+			(lookup->findFirst(vec, n, tol) == RC::SUCCESS ? found : missing).push_back(i);
+		}
+
+		delete vec;
+		return RC::SUCCESS;
+	}
+
+	/*
+	 * Whether every vector of op has an equal one in lookup, stops at the first missing one
+	 */
+	bool containsAll(ISet const* op, ISet const* lookup, IVector::NORM n, double tol) {
+		if (op->getSize() == 0) {
+			return true;
+		}
+		if (lookup->getSize() == 0 || lookup->getDim() != op->getDim()) {
+			return false;
+		}
+
+		IVector* vec = VectorUtils::createZeroVec(op->getDim());
+		if (!vec) {
+			return false;
+		}
+
+		bool result = true;
+		for (size_t i = 0; i < op->getSize() && result; i++) {
+			result = op->getCoords(i, vec) == RC::SUCCESS && lookup->findFirst(vec, n, tol) == RC::SUCCESS;
+		}
+
+		delete vec;
+		return result;
+	}
+
+	/*
+	 * Coordinates of op vectors with given indices one after another, of all vectors if indices is nullptr
+	 */
+	RC getBlock(ISet const* op, const std::vector<size_t>* indices, std::vector<double>& block) {
+		size_t count = indices ? indices->size() : op->getSize();
+		size_t dim = op->getDim();
+		block.resize(count * dim);
+
+		IVector* vec = VectorUtils::createZeroVec(dim);
+		if (!vec) {
+			return RC::ALLOCATION_ERROR;
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			RC rc = op->getCoords(indices ? (*indices)[i] : i, vec);
+			if (rc != RC::SUCCESS) {
+				delete vec;
+				return rc;
+			}
+			std::copy(vec->getData(), vec->getData() + dim, block.begin() + i * dim);
+		}
+
+		delete vec;
+		return RC::SUCCESS;
+	}
+
+	/*
+	 * Vectors with given indices are removed from the back, so that indices of the rest don't shift.
+	 * Set only marks them removed and compacts its storage once
+	 */
+	RC removeAll(ISet* set, const std::vector<size_t>& indices) {
+		for (auto it = indices.rbegin(); it != indices.rend(); ++it) {
+			RC rc = set->remove(*it);
+			if (rc != RC::SUCCESS) {
+				return rc;
+			}
+		}
+		return RC::SUCCESS;
+	}
+
+	/*
+	 * Vectors are inserted by one block, which reserves capacity once. Set without own index gets
+	 * a k-d tree for the time of insert, it finds duplicates faster than the hash grid built by
+	 * insertMany when tol is small
+	 */
+	RC insertAll(ISet* set, ISet const* op, const std::vector<size_t>* indices, IVector::NORM n, double tol) {
+		size_t count = indices ? indices->size() : op->getSize();
+		if (count == 0) {
+			return RC::SUCCESS;
+		}
+
+		std::vector<double> block;
+		RC rc = getBlock(op, indices, block);
+		if (rc != RC::SUCCESS) {
+			return rc;
+		}
+
+		bool hasNoIndex = set->getIndex() == ISet::INDEX::NONE;
+		if (hasNoIndex) {
+			set->setIndex(ISet::INDEX::KD_TREE);
+		}
+		rc = set->insertMany(count, op->getDim(), block.data(), n, tol);
+		if (hasNoIndex) {
+			set->setIndex(ISet::INDEX::NONE);
+		}
+		return rc;
+	}
+
+} // namespace
+
 ISet* ISet::makeIntersection(ISet const* const& op1,
 							 ISet const* const& op2,
 							 IVector::NORM n,
@@ -205,31 +686,30 @@ ISet* ISet::makeIntersection(ISet const* const& op1,
 		return nullptr;
 	}
 
-	ISet* intersection = createSet();
-	if (!intersection) {
+	ISet* owned;
+	ISet const* lookup = getIndexed(op2, owned);
+	if (!lookup) {
 		return nullptr;
 	}
 
-	IVector* vec = VectorUtils::createZeroVec(op1->getDim());
-	if (!vec) {
+	std::vector<size_t> found;
+	std::vector<size_t> missing;
+	RC rc = match(op1, lookup, n, tol, found, missing);
+	delete owned;
+	if (rc != RC::SUCCESS) {
 		return nullptr;
 	}
 
-	for (size_t i = 0; i < op1->getSize(); i++) {
-		op1->getCoords(i, vec);
-
-		if (op2->findFirst(vec, n, tol) == RC::SUCCESS) {
-
-			RC rc = intersection->insert(vec, n, tol);
-			if (rc != RC::SUCCESS) {
-				delete vec;
-				delete intersection;
-				return nullptr;
-			}
-		}
+	ISet* intersection = createSet();
+	if (!intersection) {
+		return nullptr;
 	}
 
-	delete vec;
+	// Vectors of op1 closer than tol to each other are kept once, as if inserted one by one
+	if (insertAll(intersection, op1, &found, n, tol) != RC::SUCCESS) {
+		delete intersection;
+		return nullptr;
+	}
 	return intersection;
 }
 
@@ -244,23 +724,11 @@ ISet* ISet::makeUnion(ISet const* const& op1, ISet const* const& op2, IVector::N
 		return nullptr;
 	}
 
-	IVector* vec = VectorUtils::createZeroVec(op2->getDim());
-	if (!vec) {
+	// Block insert searches duplicates through the index of op1 or a temporary k-d tree
+	if (insertAll(unionSet, op2, nullptr, n, tol) != RC::SUCCESS) {
+		delete unionSet;
 		return nullptr;
 	}
-
-	for (size_t i = 0; i < op2->getSize(); i++) {
-		op2->getCoords(i, vec);
-
-		RC rc = unionSet->insert(vec, n, tol);
-		if (rc != RC::SUCCESS && rc != RC::VECTOR_ALREADY_EXIST) {
-			delete vec;
-			delete unionSet;
-			return nullptr;
-		}
-	}
-
-	delete vec;
 	return unionSet;
 }
 
@@ -270,67 +738,113 @@ ISet* ISet::sub(ISet const* const& op1, ISet const* const& op2, IVector::NORM n,
 		return nullptr;
 	}
 
-	ISet* sub = op1->clone();
-	if (!sub) {
+	ISet* owned;
+	ISet const* lookup = getIndexed(op2, owned);
+	if (!lookup) {
 		return nullptr;
 	}
 
-	IVector* vec = VectorUtils::createZeroVec(op2->getDim());
-	if (!vec) {
+	std::vector<size_t> found;
+	std::vector<size_t> missing;
+	RC rc = match(op1, lookup, n, tol, found, missing);
+	delete owned;
+	if (rc != RC::SUCCESS) {
 		return nullptr;
 	}
 
-	for (size_t i = 0; i < op2->getSize(); i++) {
-		op2->getCoords(i, vec);
-
-		RC rc = sub->remove(vec, n, tol);
-		if (rc != RC::SUCCESS && rc != RC::VECTOR_NOT_FOUND) {
-			delete vec;
-			delete sub;
-			return nullptr;
-		}
+	ISet* sub = op1->clone();
+	if (!sub) {
+		return nullptr;
 	}
 
-	delete vec;
+	if (removeAll(sub, found) != RC::SUCCESS) {
+		delete sub;
+		return nullptr;
+	}
 	return sub;
 }
 
 ISet* ISet::symSub(ISet const* const& op1, ISet const* const& op2, IVector::NORM n, double tol) {
-	auto unionSet = makeUnion(op1, op2, n, tol);
-	auto intersectionSet = makeIntersection(op1, op2, n, tol);
-	ISet* symSub = sub(unionSet, intersectionSet, n, tol);
+	if (!op1 || !op2) {
+		log_severe(RC::NULLPTR_ERROR);
+		return nullptr;
+	}
+
+	ISet* owned1;
+	ISet* owned2;
+	ISet const* lookup1 = getIndexed(op1, owned1);
+	ISet const* lookup2 = getIndexed(op2, owned2);
+
+	std::vector<size_t> found1;
+	std::vector<size_t> missing1;
+	std::vector<size_t> found2;
+	std::vector<size_t> missing2;
+	RC rc = RC::ALLOCATION_ERROR;
+	if (lookup1 && lookup2) {
+		rc = match(op1, lookup2, n, tol, found1, missing1);
+	}
+	if (rc == RC::SUCCESS) {
+		rc = match(op2, lookup1, n, tol, found2, missing2);
+	}
+	delete owned1;
+	delete owned2;
+	if (rc != RC::SUCCESS) {
+		return nullptr;
+	}
 
-	delete unionSet;
-	delete intersectionSet;
+	ISet* symSub = op1->clone();
+	if (!symSub) {
+		return nullptr;
+	}
+
+	// Vectors of op2 missing in op1 can't be equal to the ones left from op1
+	rc = removeAll(symSub, found1);
+	if (rc == RC::SUCCESS) {
+		rc = insertAll(symSub, op2, &missing2, n, tol);
+	}
+	if (rc != RC::SUCCESS) {
+		delete symSub;
+		return nullptr;
+	}
 	return symSub;
 }
 
 bool ISet::equals(ISet const* const& op1, ISet const* const& op2, IVector::NORM n, double tol) {
-	ISet* subRes = symSub(op1, op2, n, tol);
-	bool res = subRes && !subRes->getSize();
-	delete subRes;
-	return res;
+	if (!op1 || !op2) {
+		log_severe(RC::NULLPTR_ERROR);
+		return false;
+	}
+
+	// Index over op1 is built only if op1 is a subset of op2
+	return subSet(op1, op2, n, tol) && subSet(op2, op1, n, tol);
 }
 
 bool ISet::subSet(ISet const* const& op1, ISet const* const& op2, IVector::NORM n, double tol) {
-	auto intersectionSet = makeIntersection(op1, op2, n, tol);
-	bool res = equals(intersectionSet, op1, n, tol);
-	delete intersectionSet;
-	return res;
+	if (!op1 || !op2) {
+		log_severe(RC::NULLPTR_ERROR);
+		return false;
+	}
+
+	ISet* owned;
+	ISet const* lookup = getIndexed(op2, owned);
+	bool result = lookup && containsAll(op1, lookup, n, tol);
+	delete owned;
+	return result;
 }
 
 ISet* Set::clone() const {
-	Set* copy = createSet();
+	Set* copy = createSet(m_precision);
 	if (!copy) {
 		return copy;
 	}
 
 	copy->m_dim = m_dim;
+	copy->m_index = m_index;
+	copy->m_garbageRatio = m_garbageRatio;
 	copy->m_capacity = m_capacity;
 	copy->m_topHash = m_topHash;
-	copy->m_size = m_size;
 
-	copy->m_data = new (std::nothrow) double[m_dim * m_capacity];
+	copy->m_data = new (std::nothrow) uint8_t[vecDataSize() * m_capacity];
 	copy->m_hashArr = new (std::nothrow) size_t[m_capacity];
 
 	if (!copy->m_data || !copy->m_hashArr) {
@@ -339,23 +853,32 @@ ISet* Set::clone() const {
 		return nullptr;
 	}
 
-	memcpy(copy->m_data, m_data, vecDataSize() * m_size);
-	memcpy(copy->m_hashArr, m_hashArr, sizeof(size_t) * m_size);
+	// Copy gets live rows only
+	for (size_t i = 0; i < m_rowCount; i++) {
+		if (m_tombstones.isLive(i)) {
+			memcpy(copy->getRow(copy->m_size), getRow(i), vecDataSize());
+			copy->m_hashArr[copy->m_size] = m_hashArr[i];
+			copy->m_size++;
+		}
+	}
+	copy->m_rowCount = copy->m_size;
+	copy->m_tombstones.reset(copy->m_size);
 	return copy;
 }
 
 ISet::~ISet() = default;
 
 RC Set::getNextVec(IVector* vector, size_t& key, size_t inc) {
-	auto it = std::upper_bound(m_hashArr, m_hashArr + m_size, key);
-	it += inc - 1;
+	// Key of the iterator may be removed already, its rank is where it would be among live rows
+	size_t index = std::upper_bound(m_hashArr, m_hashArr + m_rowCount, key) - m_hashArr;
+	size_t rank = m_tombstones.getRank(index) + inc - 1;
 
-	if (it >= m_hashArr + m_size) {
+	if (rank >= m_size) {
 		return RC::SET_INDEX_OVERFLOW;
 	}
 
-	size_t index = it - m_hashArr;
-	RC rc = getCoords(index, vector);
+	index = m_tombstones.getRow(rank);
+	RC rc = copyRowCoords(index, vector);
 	if (rc != RC::SUCCESS) {
 		return rc;
 	}
@@ -365,15 +888,15 @@ RC Set::getNextVec(IVector* vector, size_t& key, size_t inc) {
 }
 
 RC Set::getPrevVec(IVector* vector, size_t& key, size_t dec) {
-	auto it = std::lower_bound(m_hashArr, m_hashArr + m_size, key);
-	it -= dec;
+	size_t index = std::lower_bound(m_hashArr, m_hashArr + m_rowCount, key) - m_hashArr;
+	size_t rank = m_tombstones.getRank(index);
 
-	if (it < m_hashArr) {
+	if (dec > rank) {
 		return RC::SET_INDEX_OVERFLOW;
 	}
 
-	size_t index = it - m_hashArr;
-	RC rc = getCoords(index, vector);
+	index = m_tombstones.getRow(rank - dec);
+	RC rc = copyRowCoords(index, vector);
 	if (rc != RC::SUCCESS) {
 		return rc;
 	}
@@ -388,7 +911,7 @@ RC Set::getBeginVec(IVector* vector, size_t& key) {
 		return rc;
 	}
 
-	key = m_hashArr[0];
+	key = m_hashArr[m_tombstones.getRow(0)];
 	return RC::SUCCESS;
 }
 
@@ -398,16 +921,17 @@ RC Set::getEndVec(IVector* vector, size_t& key) {
 		return rc;
 	}
 
-	key = m_hashArr[m_size - 1];
+	key = m_hashArr[m_tombstones.getRow(m_size - 1)];
 	return RC::SUCCESS;
 }
 
-Set* Set::createSet() {
+Set* Set::createSet(IVector::PRECISION precision) {
 	auto set = new (std::nothrow) Set();
 	if (!set) {
 		log_warning(RC::ALLOCATION_ERROR);
 		return nullptr;
 	}
+	set->m_precision = precision;
 
 	auto controlBlock = new (std::nothrow) SetControlBlock(set);
 	if (!controlBlock) {
@@ -430,7 +954,7 @@ ISet::IIterator* Set::getIterator(size_t index) const {
 		return nullptr;
 	}
 
-	auto iterator = new (std::nothrow) Set::Iterator(m_controlBlock, vec, m_hashArr[index]);
+	auto iterator = new (std::nothrow) Set::Iterator(m_controlBlock, vec, m_hashArr[m_tombstones.getRow(index)]);
 	if (!iterator) {
 		log_warning(RC::ALLOCATION_ERROR);
 		delete vec;
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <ISet.h>
 #include <ISetControlBlock.h>
 
 #include "LogUtils.h"
+#include "SetHashGrid.h"
+#include "SetKdTree.h"
+#include "SetTombstones.h"
 
 using LogUtils::LogContainer;
 class SetControlBlock;
@@ -14,6 +19,12 @@ class Set : public ISet, public LogContainer<Set> {
 public:
 	ISet* clone() const override;
 
+	RC setIndex(INDEX index) override;
+	INDEX getIndex() const override;
+
+	RC setGarbageRatio(double ratio) override;
+	double getGarbageRatio() const override;
+
 	size_t getDim() const override;
 	size_t getSize() const override;
 	RC getCopy(size_t index, IVector*& val) const override;
@@ -28,6 +39,13 @@ public:
 
 	RC insert(IVector const* const& val, IVector::NORM n, double tol) override;
 
+	/*
+	 * Capacity is reserved once. Without own index of the set the block is deduplicated through
+	 * a temporary hash grid over the set and accepted vectors
+	 */
+	RC insertMany(size_t count, size_t dim, double const* coords, IVector::NORM n, double tol,
+				  RC* statuses) override;
+
 	RC remove(size_t index) override;
 	RC remove(IVector const* const& pat, IVector::NORM n, double tol) override;
 
@@ -70,27 +88,91 @@ public:
 	RC getBeginVec(IVector* vector, size_t& key);
 	RC getEndVec(IVector* vector, size_t& key);
 
-	static Set* createSet();
+	static Set* createSet(IVector::PRECISION precision = IVector::PRECISION::DOUBLE);
 
 	~Set() override;
 
 private:
 	Set() = default;
 
-	double* m_data = nullptr;
+	// Rows of m_dim doubles or floats depending on precision
+	uint8_t* m_data = nullptr;
+	IVector::PRECISION m_precision = IVector::PRECISION::DOUBLE;
 	size_t* m_hashArr = nullptr;
 	size_t m_topHash = 0;
 
 	size_t m_dim = 0;
 	size_t m_capacity = 0;
-	size_t m_size = 0;
+	size_t m_size = 0; // Live vectors, indices of the interface are their ranks among stored rows
+	size_t m_rowCount = 0; // Stored rows including removed ones waiting for compaction
+
+	SetTombstones m_tombstones;
+	double m_garbageRatio = 0.5;
 
 	std::shared_ptr<SetControlBlock> m_controlBlock;
 
+	INDEX m_index = INDEX::NONE;
+
+	// Built by lookups, so const lookups that build them must not run concurrently
+	mutable SetHashGrid m_hashGrid;
+	mutable SetKdTree m_kdTree;
+
 	size_t vecDataSize() const;
 
+	/*
+	 * Row of the first equal vector, rows are positions in storage rather than indices of the interface
+	 */
 	RC findFirst(IVector const* pat, IVector::NORM n, double tol, size_t& index) const;
+	// Same for m_dim coordinates of pattern
+	RC findFirst(const double* pat, IVector::NORM n, double tol, size_t& index) const;
+
+	/*
+	 * Scans rows listed in ascending indices, all live rows if indices is nullptr
+	 */
+	RC findFirstIn(const double* pat, IVector::NORM n, double tol, const size_t* indices, size_t count,
+				   size_t& index) const;
+
+	/*
+	 * Ascending indices of rows the index can't rule out, false if the whole set has to be scanned
+	 */
+	bool getCandidates(const double* pat, double tol, std::vector<size_t>& indices) const;
+
+	/*
+	 * Sorts and deduplicates keys, indices of their rows come in ascending order
+	 */
+	void getIndicesByKeys(std::vector<size_t>& keys, std::vector<size_t>& indices) const;
+	size_t getIndexByKey(size_t key) const;
+	SetKdTree::RowByKey getRowByKey() const;
+
+	/*
+	 * Keep built indices in sync with a row that is already in the set
+	 */
+	void indexInsert(size_t index);
+	void indexRemove(size_t index);
+	void clearIndex();
+	RC copyRow(size_t index, IVector*& val) const;
+	RC copyRowCoords(size_t index, IVector* const& val) const;
+	RC removeRow(size_t index);
+
+	/*
+	 * Moves live rows together, keys and so the built indices stay valid
+	 */
+	void compact();
+
+	uint8_t* getRow(size_t index) const;
 	double* getData(size_t index) const;
+	float* getFloatData(size_t index) const;
+
+	/*
+	 * Row converted to double, points into the set itself for DOUBLE storage or to buffer otherwise
+	 */
+	const double* getData(size_t index, std::vector<double>& buffer) const;
 
 	bool enlarge();
+	bool reserve(size_t capacity);
+
+	/*
+	 * Appends row after capacity is reserved, floatData is used as is for FLOAT storage if present
+	 */
+	RC appendRow(const double* data, const float* floatData);
 };
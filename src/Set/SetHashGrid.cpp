@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SetHashGrid.h"
+
+namespace {
+
+	/*
+	 * Beyond this many cells from origin rounding of coords / tol may shift cell by one,
+	 * farther coordinates are clamped and patterns there are searched without the grid
+	 */
+	const double CELL_LIMIT = 1099511627776.0; // 2^40
+
+} // namespace
+
+const size_t SetHashGrid::HASHED_AXES;
+
+void SetHashGrid::reset(size_t dim, double tol) {
+	m_cells.clear();
+	m_axes = std::min(dim, HASHED_AXES);
+	m_tol = tol;
+}
+
+void SetHashGrid::clear() {
+	m_cells.clear();
+	m_axes = 0;
+	m_tol = 0;
+}
+
+bool SetHashGrid::isBuilt() const { return m_tol > 0; }
+
+double SetHashGrid::getTol() const { return m_tol; }
+
+bool SetHashGrid::getCell(const double* coords, int64_t* cell) const {
+	bool isReliable = true;
+	for (size_t i = 0; i < m_axes; i++) {
+		double position = std::floor(coords[i] / m_tol);
+		if (!(std::fabs(position) < CELL_LIMIT)) {
+			isReliable = false;
+			position = position < 0 ? -CELL_LIMIT : CELL_LIMIT;
+		}
+		cell[i] = static_cast<int64_t>(position);
+	}
+	return isReliable;
+}
+
+uint64_t SetHashGrid::hashCell(const int64_t* cell, size_t axes) {
+	uint64_t hash = 0;
+	for (size_t i = 0; i < axes; i++) {
+		// splitmix64 finalizer keeps neighbouring cells in different buckets
+		uint64_t value = hash + static_cast<uint64_t>(cell[i]) + 0x9E3779B97F4A7C15ULL;
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+		hash = value ^ (value >> 31);
+	}
+	return hash;
+}
+
+void SetHashGrid::insert(const double* coords, size_t key) {
+	int64_t cell[HASHED_AXES];
+	getCell(coords, cell);
+	m_cells[hashCell(cell, m_axes)].push_back(key);
+}
+
+void SetHashGrid::remove(const double* coords, size_t key) {
+	int64_t cell[HASHED_AXES];
+	getCell(coords, cell);
+
+	auto bucket = m_cells.find(hashCell(cell, m_axes));
+	if (bucket == m_cells.end()) {
+		return;
+	}
+
+	std::vector<size_t>& keys = bucket->second;
+	auto found = std::find(keys.begin(), keys.end(), key);
+	if (found != keys.end()) {
+		*found = keys.back();
+		keys.pop_back();
+	}
+	if (keys.empty()) {
+		m_cells.erase(bucket);
+	}
+}
+
+bool SetHashGrid::getCandidates(const double* pat, std::vector<size_t>& keys) const {
+	int64_t center[HASHED_AXES];
+	if (!getCell(pat, center)) {
+		return false;
+	}
+
+	// Walks offsets -1..1 along every axis like an odometer
+	int64_t offset[HASHED_AXES];
+	int64_t cell[HASHED_AXES];
+	std::fill(offset, offset + m_axes, -1);
+
+	for (;;) {
+		for (size_t i = 0; i < m_axes; i++) {
+			cell[i] = center[i] + offset[i];
+		}
+
+		auto bucket = m_cells.find(hashCell(cell, m_axes));
+		if (bucket != m_cells.end()) {
+			keys.insert(keys.end(), bucket->second.begin(), bucket->second.end());
+		}
+
+		size_t axis = 0;
+		while (axis < m_axes && offset[axis] == 1) {
+			offset[axis++] = -1;
+		}
+		if (axis == m_axes) {
+			break;
+		}
+		offset[axis]++;
+	}
+	return true;
+}
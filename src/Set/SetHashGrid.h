@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Keys of set rows bucketed by cells of size tol along the first HASHED_AXES coordinates.
+ * Vectors closer than tol in any of the norms differ by less than tol in every coordinate,
+ * so all of them lie in the 3^axes cells around a pattern. Buckets may share cells on hash
+ * collisions, candidates are always compared exactly by the set
+ */
+class SetHashGrid {
+public:
+	/*
+	 * Drops all keys and starts a grid with new cell size
+	 */
+	void reset(size_t dim, double tol);
+	void clear();
+
+	bool isBuilt() const;
+	double getTol() const;
+
+	void insert(const double* coords, size_t key);
+	void remove(const double* coords, size_t key);
+
+	/*
+	 * Appends keys from cells around pattern, false if pattern is too far from origin
+	 * relative to tol to be quantized reliably and has to be searched without the grid
+	 */
+	bool getCandidates(const double* pat, std::vector<size_t>& keys) const;
+
+private:
+	// 27 cells are probed at most, more axes cost more probes than they filter out
+	static const size_t HASHED_AXES = 3;
+
+	bool getCell(const double* coords, int64_t* cell) const;
+	static uint64_t hashCell(const int64_t* cell, size_t axes);
+
+	std::unordered_map<uint64_t, std::vector<size_t>> m_cells;
+
+	size_t m_axes = 0;
+	double m_tol = 0;
+};
@@ -94,7 +94,8 @@ RC Set::Iterator::getVectorCopy(IVector*& val) const {
 }
 
 RC Set::Iterator::getVectorCoords(IVector* const& val) const {
-	return val->setData(m_vector->getDim(), m_vector->getData());
+	// Vector of a FLOAT set has no double coordinates to pass to setData
+	return IVector::copyInstance(val, m_vector);
 }
 
 ISet::IIterator::~IIterator() = default;
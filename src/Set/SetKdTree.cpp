@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SetKdTree.h"
+
+const uint32_t SetKdTree::NIL;
+constexpr double SetKdTree::BALANCE;
+const size_t SetKdTree::SPREAD_SAMPLE;
+
+void SetKdTree::reset(size_t dim, bool isFloat) {
+	clear();
+	m_dim = dim;
+	m_isFloat = isFloat;
+}
+
+void SetKdTree::clear() {
+	m_nodes.clear();
+	m_freeNodes.clear();
+	m_nodeByKey.clear();
+	m_root = NIL;
+	m_removedCount = 0;
+	m_isBuilt = false;
+}
+
+bool SetKdTree::isBuilt() const { return m_isBuilt; }
+
+double SetKdTree::getCoord(const uint8_t* row, size_t axis) const {
+	if (m_isFloat) {
+		return reinterpret_cast<const float*>(row)[axis];
+	}
+	return reinterpret_cast<const double*>(row)[axis];
+}
+
+uint32_t SetKdTree::allocateNode() {
+	if (!m_freeNodes.empty()) {
+		uint32_t node = m_freeNodes.back();
+		m_freeNodes.pop_back();
+		return node;
+	}
+
+	m_nodes.push_back(Node());
+	return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+size_t SetKdTree::chooseAxis(const Point* begin, const Point* end) const {
+	size_t step = std::max(size_t(1), static_cast<size_t>(end - begin) / SPREAD_SAMPLE);
+
+	size_t bestAxis = 0;
+	double bestSpread = -1;
+	for (size_t axis = 0; axis < m_dim; axis++) {
+		double min = getCoord(begin->row, axis);
+		double max = min;
+		for (const Point* point = begin; point < end; point += step) {
+			double coord = getCoord(point->row, axis);
+			min = std::min(min, coord);
+			max = std::max(max, coord);
+		}
+
+		if (max - min > bestSpread) {
+			bestSpread = max - min;
+			bestAxis = axis;
+		}
+	}
+	return bestAxis;
+}
+
+uint32_t SetKdTree::buildSubtree(Point* begin, Point* end) {
+	if (begin == end) {
+		return NIL;
+	}
+
+	size_t axis = chooseAxis(begin, end);
+	Point* median = begin + (end - begin) / 2;
+	std::nth_element(begin, median, end, [this, axis](const Point& a, const Point& b) {
+		return getCoord(a.row, axis) < getCoord(b.row, axis);
+	});
+
+	// Children are built after the node is filled in, allocation may move m_nodes
+	uint32_t node = median->node;
+	if (node == NIL) {
+		node = allocateNode();
+		m_nodeByKey[median->key] = node;
+	}
+	m_nodes[node] = { median->key, getCoord(median->row, axis), NIL, NIL, static_cast<uint32_t>(end - begin),
+					  static_cast<uint32_t>(axis), false };
+
+	uint32_t left = buildSubtree(begin, median);
+	uint32_t right = buildSubtree(median + 1, end);
+	m_nodes[node].left = left;
+	m_nodes[node].right = right;
+	return node;
+}
+
+void SetKdTree::build(std::vector<Point>& points) {
+	reset(m_dim, m_isFloat);
+	for (auto& point : points) {
+		point.node = NIL;
+	}
+	m_root = buildSubtree(points.data(), points.data() + points.size());
+	m_isBuilt = true;
+}
+
+void SetKdTree::collectPoints(uint32_t node, const RowByKey& rowByKey, std::vector<Point>& points) {
+	std::vector<uint32_t> stack = { node };
+	while (!stack.empty()) {
+		node = stack.back();
+		stack.pop_back();
+		if (node == NIL) {
+			continue;
+		}
+
+		const Node& current = m_nodes[node];
+		if (current.isRemoved) {
+			m_removedCount--;
+			m_freeNodes.push_back(node);
+		} else {
+			points.push_back({ current.key, rowByKey(current.key), node });
+		}
+
+		stack.push_back(current.left);
+		stack.push_back(current.right);
+	}
+}
+
+uint32_t SetKdTree::rebuildSubtree(uint32_t node, const RowByKey& rowByKey) {
+	std::vector<Point> points;
+	collectPoints(node, rowByKey, points);
+	return buildSubtree(points.data(), points.data() + points.size());
+}
+
+size_t SetKdTree::maxDepth() const {
+	double size = m_root == NIL ? 1 : m_nodes[m_root].size;
+	return static_cast<size_t>(std::log(size) / std::log(1 / BALANCE)) + 2;
+}
+
+void SetKdTree::insert(size_t key, const uint8_t* row, const RowByKey& rowByKey) {
+	if (!m_isBuilt || m_dim == 0) {
+		return;
+	}
+
+	uint32_t leaf = allocateNode();
+	m_nodes[leaf] = { key, 0, NIL, NIL, 1, 0, false };
+	m_nodeByKey[key] = leaf;
+
+	std::vector<uint32_t> path;
+	for (uint32_t node = m_root; node != NIL;) {
+		path.push_back(node);
+		Node& current = m_nodes[node];
+		current.size++;
+
+		uint32_t& child = getCoord(row, current.axis) < current.split ? current.left : current.right;
+		if (child == NIL) {
+			child = leaf;
+			m_nodes[leaf].axis = static_cast<uint32_t>((current.axis + 1) % m_dim);
+			break;
+		}
+		node = child;
+	}
+	m_nodes[leaf].split = getCoord(row, m_nodes[leaf].axis);
+
+	if (path.empty()) {
+		m_root = leaf;
+		return;
+	}
+
+	if (path.size() + 1 <= maxDepth()) {
+		return;
+	}
+
+	// The deepest ancestor with too heavy child on the path is rebuilt balanced
+	for (size_t i = path.size(); i-- > 0;) {
+		uint32_t child = i + 1 < path.size() ? path[i + 1] : leaf;
+		uint32_t oldSize = m_nodes[path[i]].size;
+		if (m_nodes[child].size <= BALANCE * oldSize) {
+			continue;
+		}
+
+		uint32_t rebuilt = rebuildSubtree(path[i], rowByKey);
+		uint32_t newSize = rebuilt == NIL ? 0 : m_nodes[rebuilt].size;
+
+		if (i == 0) {
+			m_root = rebuilt;
+		} else {
+			Node& parent = m_nodes[path[i - 1]];
+			(parent.left == path[i] ? parent.left : parent.right) = rebuilt;
+		}
+
+		// Removed nodes dropped by rebuild leave the sizes of ancestors
+		for (size_t j = 0; j < i; j++) {
+			m_nodes[path[j]].size -= oldSize - newSize;
+		}
+		break;
+	}
+}
+
+void SetKdTree::remove(size_t key, const RowByKey& rowByKey) {
+	auto found = m_nodeByKey.find(key);
+	if (!m_isBuilt || found == m_nodeByKey.end()) {
+		return;
+	}
+
+	m_nodes[found->second].isRemoved = true;
+	m_nodeByKey.erase(found);
+	m_removedCount++;
+
+	if (m_removedCount * 2 > m_nodes[m_root].size) {
+		m_root = rebuildSubtree(m_root, rowByKey);
+	}
+}
+
+void SetKdTree::getCandidates(const double* pat, double tol, std::vector<size_t>& keys) const {
+	if (m_root == NIL) {
+		return;
+	}
+
+	// Left subtree holds coordinates not greater than split, right one not less
+	std::vector<uint32_t> stack = { m_root };
+	while (!stack.empty()) {
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+
+		double diff = pat[node.axis] - node.split;
+		if (!node.isRemoved && std::fabs(diff) < tol) {
+			keys.push_back(node.key);
+		}
+		if (node.left != NIL && diff < tol) {
+			stack.push_back(node.left);
+		}
+		if (node.right != NIL && -diff < tol) {
+			stack.push_back(node.right);
+		}
+	}
+}
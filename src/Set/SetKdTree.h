@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * k-d tree over keys of set rows. Every node is a row splitting its subtree by one coordinate,
+ * the axis of the largest spread is chosen on bulk build, so it stays selective in higher dimensions.
+ * Tree doesn't copy coordinates, rows are read through pointers valid only during a call
+ *
+ * Inserts rebuild the subtree of a scapegoat once a path gets too deep, removed nodes are only
+ * marked and the whole tree is rebuilt when they become the majority
+ */
+class SetKdTree {
+public:
+	using RowByKey = std::function<const uint8_t*(size_t key)>;
+
+	// Missing node, points passed to build get a new one
+	static const uint32_t NIL = UINT32_MAX;
+
+	struct Point {
+		size_t key;
+		const uint8_t* row;
+		uint32_t node; // Kept by rebuilt subtrees, so that nodes of keys don't move
+	};
+
+	void reset(size_t dim, bool isFloat);
+	void clear();
+
+	bool isBuilt() const;
+
+	/*
+	 * Replaces content of the tree with balanced one over points
+	 */
+	void build(std::vector<Point>& points);
+
+	void insert(size_t key, const uint8_t* row, const RowByKey& rowByKey);
+	void remove(size_t key, const RowByKey& rowByKey);
+
+	/*
+	 * Appends keys of rows that are closer than tol to pattern along their split axis. Rows closer
+	 * than tol in any of the norms are among them, exact comparison is left to the set
+	 */
+	void getCandidates(const double* pat, double tol, std::vector<size_t>& keys) const;
+
+private:
+	// Subtree is rebuilt when one of children holds more than this share of it
+	static constexpr double BALANCE = 0.7;
+
+	// Axis of bulk built nodes is chosen by spread of this many points at most
+	static const size_t SPREAD_SAMPLE = 16;
+
+	struct Node {
+		size_t key;
+		double split;
+		uint32_t left;
+		uint32_t right;
+		uint32_t size; // Nodes in subtree including removed ones
+		uint32_t axis;
+		bool isRemoved;
+	};
+
+	double getCoord(const uint8_t* row, size_t axis) const;
+
+	uint32_t allocateNode();
+	uint32_t buildSubtree(Point* begin, Point* end);
+	size_t chooseAxis(const Point* begin, const Point* end) const;
+
+	void collectPoints(uint32_t node, const RowByKey& rowByKey, std::vector<Point>& points);
+	uint32_t rebuildSubtree(uint32_t node, const RowByKey& rowByKey);
+
+	size_t maxDepth() const;
+
+	std::vector<Node> m_nodes;
+	std::vector<uint32_t> m_freeNodes;
+	std::unordered_map<size_t, uint32_t> m_nodeByKey;
+
+	uint32_t m_root = NIL;
+	size_t m_removedCount = 0;
+
+	size_t m_dim = 0;
+	bool m_isFloat = false;
+	bool m_isBuilt = false;
+};
@@ -0,0 +1,82 @@
+#include "SetTombstones.h"
+
+namespace {
+
+	size_t lowBit(size_t i) { return i & (~i + 1); }
+
+} // namespace
+
+void SetTombstones::reset(size_t count) {
+	m_isLive.clear();
+	m_tree.clear();
+	m_count = count;
+	m_removedCount = 0;
+}
+
+void SetTombstones::append() {
+	m_count++;
+	if (m_removedCount == 0) {
+		return;
+	}
+
+	m_isLive.push_back(1);
+	m_tree.push_back(1 + getPrefix(m_count - 1) - getPrefix(m_count - lowBit(m_count)));
+}
+
+void SetTombstones::remove(size_t row) {
+	// Tree is built by the first removal only
+	if (m_removedCount == 0) {
+		m_isLive.assign(m_count, 1);
+		m_tree.assign(m_count + 1, 0);
+		for (size_t i = 1; i <= m_count; i++) {
+			m_tree[i]++;
+			if (i + lowBit(i) <= m_count) {
+				m_tree[i + lowBit(i)] += m_tree[i];
+			}
+		}
+	}
+
+	m_isLive[row] = 0;
+	for (size_t i = row + 1; i <= m_count; i += lowBit(i)) {
+		m_tree[i]--;
+	}
+	m_removedCount++;
+}
+
+size_t SetTombstones::getRemovedCount() const { return m_removedCount; }
+
+size_t SetTombstones::getPrefix(size_t count) const {
+	size_t sum = 0;
+	for (size_t i = count; i > 0; i -= lowBit(i)) {
+		sum += m_tree[i];
+	}
+	return sum;
+}
+
+size_t SetTombstones::getRank(size_t row) const {
+	if (m_removedCount == 0) {
+		return row;
+	}
+	return getPrefix(row);
+}
+
+size_t SetTombstones::getRow(size_t rank) const {
+	if (m_removedCount == 0) {
+		return rank;
+	}
+
+	size_t step = 1;
+	while (step * 2 <= m_count) {
+		step *= 2;
+	}
+
+	// Descends to the longest prefix holding no more than rank live rows
+	size_t position = 0;
+	for (; step > 0; step /= 2) {
+		if (position + step <= m_count && m_tree[position + step] <= rank) {
+			position += step;
+			rank -= m_tree[position];
+		}
+	}
+	return position;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Liveness of stored rows of a set, removed rows stay in storage until it is compacted.
+ * Live rows are ranked by a Fenwick tree, so both rank of a row and row of a rank take O(log n).
+ * Nothing is kept while no row is removed, ranks are rows themselves then
+ */
+class SetTombstones {
+public:
+	/*
+	 * Forgets removed rows, all count rows are live
+	 */
+	void reset(size_t count);
+
+	void append();
+	void remove(size_t row);
+
+	// Checked for every row by scans of the set, so it is kept inline
+	bool isLive(size_t row) const { return m_removedCount == 0 || m_isLive[row]; }
+
+	size_t getRemovedCount() const;
+
+	/*
+	 * Live rows stored before row
+	 */
+	size_t getRank(size_t row) const;
+
+	/*
+	 * Row of the live one with given rank, rank has to be less than the number of live rows
+	 */
+	size_t getRow(size_t rank) const;
+
+private:
+	size_t getPrefix(size_t count) const;
+
+	std::vector<uint8_t> m_isLive;
+	std::vector<size_t> m_tree; // 1-based, m_tree[i] counts live rows in (i - lowbit(i), i]
+
+	size_t m_count = 0;
+	size_t m_removedCount = 0;
+};
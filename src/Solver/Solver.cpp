@@ -222,10 +222,10 @@ RC Solver::splitStepMethod(const IVector* initApprox,
 		double coeff = -delta * gradNorm * gradNorm;
 
 		while (step > 0.0) {
-			IVector::copyInstance(nextApprox, grad);
-			nextApprox->scale(-step);
+			const IVector* ops[] = { currApprox, grad };
+			const double coeffs[] = { 1.0, -step };
 
-			rc = nextApprox->inc(currApprox);
+			rc = nextApprox->linearCombination(2, coeffs, ops);
 			if (rc != RC::SUCCESS) { break; }
 
 			double nextValue = m_problem->evalByArgs(nextApprox);
@@ -241,7 +241,10 @@ RC Solver::splitStepMethod(const IVector* initApprox,
 	}
 
 	if (rc == RC::SUCCESS) {
-		setSolution(currApprox);
+		// Approximation is not needed anymore, so it is handed over instead of cloned
+		delete m_solution;
+		m_solution = currApprox;
+		currApprox = nullptr;
 	}
 
 	delete currApprox;
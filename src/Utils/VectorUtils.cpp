@@ -1,6 +1,26 @@
 #include "VectorUtils.h"
 #include "LogUtils.h"
 
+namespace {
+
+	/*
+	 * Coordinates of a dense operand, FLOAT vectors keep no double ones and are read natively
+	 */
+	class Coords {
+	public:
+		explicit Coords(const IVector* vec)
+			: m_floatData(vec->getFloatData()), m_data(m_floatData ? nullptr : vec->getData()) {}
+
+		bool isValid() const { return m_floatData || m_data; }
+		double operator[](size_t i) const { return m_floatData ? m_floatData[i] : m_data[i]; }
+
+	private:
+		const float* m_floatData;
+		const double* m_data;
+	};
+
+} // namespace
+
 IVector* VectorUtils::createZeroVec(size_t dim) {
 	auto zeroData = new (std::nothrow) double[dim]();
 	auto vec = IVector::createVector(dim, zeroData);
@@ -20,22 +40,26 @@ IVector* VectorUtils::binaryOp(const IVector* a, const IVector* b, const BinaryO
 		return nullptr;
 	}
 
-	auto dataA = a->getData();
-	auto dataB = b->getData();
+	Coords dataA(a);
+	Coords dataB(b);
+	if (!dataA.isValid() || !dataB.isValid()) {
+		log_warning_in(IVector::getLogger(), RC::ALLOCATION_ERROR);
+		return nullptr;
+	}
 
-	auto res = createZeroVec(dim);
-	if (!res) {
+	auto resData = new (std::nothrow) double[dim];
+	if (!resData) {
+		log_warning_in(IVector::getLogger(), RC::ALLOCATION_ERROR);
 		return nullptr;
 	}
 
 	for (size_t i = 0; i < dim; i++) {
-		RC rc = res->setCoord(i, op(dataA[i], dataB[i]));
-		if (rc != RC::SUCCESS) {
-			delete res;
-			return nullptr;
-		}
+		resData[i] = op(dataA[i], dataB[i]);
 	}
 
+	// createVector validates the whole result at once
+	auto res = IVector::createVector(dim, resData);
+	delete[] resData;
 	return res;
 }
 
@@ -46,3 +70,40 @@ IVector* VectorUtils::min(const IVector* a, const IVector* b) {
 IVector* VectorUtils::max(const IVector* a, const IVector* b) {
     return binaryOp(a, b, std::max<double>);
 }
+
+RC VectorUtils::binaryOp(const IVector* a, const IVector* b, IVector* dest, const BinaryOp& op) {
+	if (!a || !b || !dest) {
+		log_severe_in(IVector::getLogger(), RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	size_t dim = a->getDim();
+	if (dim != b->getDim() || dim != dest->getDim()) {
+		log_warning_in(IVector::getLogger(), RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	Coords dataA(a);
+	Coords dataB(b);
+	if (!dataA.isValid() || !dataB.isValid()) {
+		log_warning_in(IVector::getLogger(), RC::ALLOCATION_ERROR);
+		return RC::ALLOCATION_ERROR;
+	}
+
+	// Blocks come in order, each operand value is read before dest overwrites it
+	size_t offset = 0;
+	return dest->applyBlockFunction([&](const double*, double* out, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			out[i] = op(dataA[offset + i], dataB[offset + i]);
+		}
+		offset += n;
+	});
+}
+
+RC VectorUtils::min(const IVector* a, const IVector* b, IVector* dest) {
+	return binaryOp(a, b, dest, std::min<double>);
+}
+
+RC VectorUtils::max(const IVector* a, const IVector* b, IVector* dest) {
+	return binaryOp(a, b, dest, std::max<double>);
+}
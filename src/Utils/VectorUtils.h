@@ -13,4 +13,12 @@ namespace VectorUtils {
 
 	IVector* min(const IVector* a, const IVector* b);
 	IVector* max(const IVector* a, const IVector* b);
+
+	/*
+	 * Write result into existing vector, dest may be one of operands
+	 */
+	RC binaryOp(const IVector* a, const IVector* b, IVector* dest, const BinaryOp& op);
+
+	RC min(const IVector* a, const IVector* b, IVector* dest);
+	RC max(const IVector* a, const IVector* b, IVector* dest);
 } // namespace VectorUtils
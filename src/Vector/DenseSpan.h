@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include <IVector.h>
+
+/*
+ * Dense operands read in their native precision. FLOAT vectors keep no double coordinates, so their
+ * spans are converted into a block owned by the caller, usually on stack
+ */
+namespace DenseSpan {
+
+	// One of the pointers is set
+	struct DenseData {
+		const double* doubles;
+		const float* floats;
+	};
+
+	const size_t BLOCK_SIZE = 256;
+
+	/*
+	 * Returns false if vector gives neither double nor float coordinates
+	 */
+	inline bool getDense(const IVector* vec, DenseData& dense) {
+		dense.floats = vec->getFloatData();
+		dense.doubles = dense.floats ? nullptr : vec->getData();
+		return dense.floats || dense.doubles;
+	}
+
+	inline double at(const DenseData& dense, size_t i) {
+		return dense.doubles ? dense.doubles[i] : dense.floats[i];
+	}
+
+	/*
+	 * Coordinates [begin, begin + len), float ones are converted into block of at least len doubles
+	 */
+	inline const double* read(const DenseData& dense, size_t begin, size_t len, double* block) {
+		if (dense.doubles) {
+			return dense.doubles + begin;
+		}
+
+		std::copy(dense.floats + begin, dense.floats + begin + len, block);
+		return block;
+	}
+
+	// Same for vector, nullptr if it gives no coordinates
+	inline const double* read(const IVector* vec, size_t begin, size_t len, double* block) {
+		DenseData dense;
+		return getDense(vec, dense) ? read(dense, begin, len, block) : nullptr;
+	}
+
+	/*
+	 * Calls fun(begin, data, len) for consecutive spans of [0, dim) of BLOCK_SIZE coordinates
+	 */
+	template<class Function>
+	void forBlocks(const DenseData& dense, size_t dim, Function fun) {
+		double block[BLOCK_SIZE];
+
+		for (size_t begin = 0; begin < dim; begin += BLOCK_SIZE) {
+			size_t len = std::min(BLOCK_SIZE, dim - begin);
+			fun(begin, read(dense, begin, len, block), len);
+		}
+	}
+
+} // namespace DenseSpan
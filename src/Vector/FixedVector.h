@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+#include <new>
+
+#include "DenseSpan.h"
+#include "Vector.h"
+#include "VectorAllocator.h"
+#include "VectorCounters.h"
+#include "VectorSummation.h"
+
+namespace {
+
+	/*
+	 * Calls f(I), f(I + 1), ..., f(N - 1) without a runtime loop
+	 */
+	template<size_t I, size_t N>
+	struct Unroll {
+		template<class F>
+		static void apply(F& f) {
+			f(I);
+			Unroll<I + 1, N>::apply(f);
+		}
+	};
+
+	template<size_t N>
+	struct Unroll<N, N> {
+		template<class F>
+		static void apply(F&) {}
+	};
+
+	/*
+	 * Vector of compile-time dimension, created by createVector for the most common small sizes
+	 *
+	 * Shares memory layout with Vector, so it is allocated and freed the same way, but arithmetic
+	 * is unrolled instead of going through runtime dispatched kernels
+	 */
+	template<size_t N>
+	class FixedVector : public Vector {
+	public:
+		RC scale(double multiplier) override;
+
+		RC inc(IVector const* const& op) override;
+		RC dec(IVector const* const& op) override;
+
+		RC axpy(double alpha, IVector const* const& op) override;
+		RC axpby(double alpha, IVector const* const& op, double beta) override;
+		RC linearCombination(size_t count, double const* coeffs, IVector const* const* ops) override;
+
+		double norm(NORM n) const override;
+
+		static FixedVector* createVector(const double* const& data);
+
+	private:
+		FixedVector();
+
+		/*
+		 * Copies res into own data if all of it is finite, unrolled check falls back to
+		 * Vector::validateData only to report the error
+		 */
+		RC store(const double* res);
+	};
+
+#include "FixedVector.tpp"
+
+} // namespace
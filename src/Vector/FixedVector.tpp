@@ -0,0 +1,249 @@
+template<size_t N>
+FixedVector<N>::FixedVector() : Vector(N) {}
+
+template<size_t N>
+FixedVector<N>* FixedVector<N>::createVector(const double* const& data) {
+	static_assert(sizeof(FixedVector) == sizeof(Vector), "FixedVector must keep Vector memory layout");
+
+	auto mem = VectorAllocator::allocate(PAYLOAD_OFFSET + N * sizeof(double));
+	if (!mem) {
+		log_warning(RC::ALLOCATION_ERROR);
+		return nullptr;
+	}
+	auto vector = new (mem) FixedVector();
+
+	if (vector->setData(N, data) != RC::SUCCESS) {
+		delete vector;
+		return nullptr;
+	}
+
+	return vector;
+}
+
+template<size_t N>
+RC FixedVector<N>::store(const double* res) {
+	bool finite = true;
+	auto check = [&](size_t i) { finite &= std::isfinite(res[i]); };
+	Unroll<0, N>::apply(check);
+
+	if (!finite) {
+		return validateData(res, N);
+	}
+
+	double* data = getData();
+	auto copy = [&](size_t i) { data[i] = res[i]; };
+	Unroll<0, N>::apply(copy);
+
+	return RC::SUCCESS;
+}
+
+template<size_t N>
+RC FixedVector<N>::scale(double multiplier) {
+	count_operation(SCALE, N);
+
+	if (!std::isfinite(multiplier)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	const double* data = getData();
+	double res[N];
+	auto op = [&](size_t i) { res[i] = data[i] * multiplier; };
+	Unroll<0, N>::apply(op);
+
+	return store(res);
+}
+
+template<size_t N>
+RC FixedVector<N>::inc(IVector const* const& op) {
+	count_operation(UPDATE, N);
+
+	if (op->getDim() != N) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	const double* data = getData();
+	double opBlock[N];
+	const double* opData = DenseSpan::read(op, 0, N, opBlock);
+	if (!opData) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	double res[N];
+	auto add = [&](size_t i) { res[i] = data[i] + opData[i]; };
+	Unroll<0, N>::apply(add);
+
+	return store(res);
+}
+
+template<size_t N>
+RC FixedVector<N>::dec(IVector const* const& op) {
+	count_operation(UPDATE, N);
+
+	if (op->getDim() != N) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	const double* data = getData();
+	double opBlock[N];
+	const double* opData = DenseSpan::read(op, 0, N, opBlock);
+	if (!opData) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	double res[N];
+	auto sub = [&](size_t i) { res[i] = data[i] - opData[i]; };
+	Unroll<0, N>::apply(sub);
+
+	return store(res);
+}
+
+template<size_t N>
+RC FixedVector<N>::axpy(double alpha, IVector const* const& op) {
+	count_operation(UPDATE, N);
+
+	if (!std::isfinite(alpha)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	if (op->getDim() != N) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	const double* data = getData();
+	double opBlock[N];
+	const double* opData = DenseSpan::read(op, 0, N, opBlock);
+	if (!opData) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	double res[N];
+	auto axpy = [&](size_t i) { res[i] = data[i] + alpha * opData[i]; };
+	Unroll<0, N>::apply(axpy);
+
+	return store(res);
+}
+
+template<size_t N>
+RC FixedVector<N>::axpby(double alpha, IVector const* const& op, double beta) {
+	count_operation(UPDATE, N);
+
+	if (!std::isfinite(alpha) || !std::isfinite(beta)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	if (op->getDim() != N) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	const double* data = getData();
+	double opBlock[N];
+	const double* opData = DenseSpan::read(op, 0, N, opBlock);
+	if (!opData) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	double res[N];
+	auto axpby = [&](size_t i) { res[i] = alpha * opData[i] + beta * data[i]; };
+	Unroll<0, N>::apply(axpby);
+
+	return store(res);
+}
+
+template<size_t N>
+RC FixedVector<N>::linearCombination(size_t count, double const* coeffs, IVector const* const* ops) {
+	count_operation(LINEAR_COMBINATION, N);
+
+	if (!coeffs || !ops) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	for (size_t k = 0; k < count; k++) {
+		if (!ops[k]) {
+			log_severe(RC::NULLPTR_ERROR);
+			return RC::NULLPTR_ERROR;
+		}
+
+		if (ops[k]->getDim() != N) {
+			log_warning(RC::MISMATCHING_DIMENSIONS);
+			return RC::MISMATCHING_DIMENSIONS;
+		}
+
+		if (!std::isfinite(coeffs[k])) {
+			log_warning(RC::INVALID_ARGUMENT);
+			return RC::INVALID_ARGUMENT;
+		}
+	}
+
+	// Accumulated apart from own data, which may be one of ops
+	double res[N] = {};
+	double opBlock[N];
+	for (size_t k = 0; k < count; k++) {
+		const double coeff = coeffs[k];
+		const double* opData = DenseSpan::read(ops[k], 0, N, opBlock);
+		if (!opData) {
+			return RC::ALLOCATION_ERROR;
+		}
+
+		auto axpy = [&](size_t i) { res[i] += coeff * opData[i]; };
+		Unroll<0, N>::apply(axpy);
+	}
+
+	return store(res);
+}
+
+template<size_t N>
+double FixedVector<N>::norm(NORM n) const {
+	count_operation(NORM, N);
+
+	const double* data = getData();
+	double res = 0;
+
+	switch (n) {
+	// N is below VectorSummation::BLOCK_SIZE, so pairwise mode sums all coordinates as one unrolled block
+	case NORM::FIRST: {
+		auto term = [&](size_t i) { return std::fabs(data[i]); };
+		res = VectorSummation::sum(N, [&](size_t, size_t) {
+			double sum = 0;
+			auto add = [&](size_t i) { sum += term(i); };
+			Unroll<0, N>::apply(add);
+			return sum;
+		}, term);
+		break;
+	}
+
+	case NORM::SECOND: {
+		auto term = [&](size_t i) { return data[i] * data[i]; };
+		res = std::sqrt(VectorSummation::sum(N, [&](size_t, size_t) {
+			double sum = 0;
+			auto add = [&](size_t i) { sum += term(i); };
+			Unroll<0, N>::apply(add);
+			return sum;
+		}, term));
+		break;
+	}
+
+	case NORM::CHEBYSHEV: {
+		auto max = [&](size_t i) { res = std::fmax(res, std::fabs(data[i])); };
+		Unroll<0, N>::apply(max);
+		break;
+	}
+
+	default:
+		log_severe(RC::UNKNOWN);
+		return NAN;
+	}
+
+	if (std::isinf(res)) {
+		log_warning(RC::INFINITY_OVERFLOW);
+	}
+
+	return res;
+}
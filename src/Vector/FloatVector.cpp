@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "DenseSpan.h"
+#include "FloatVector.h"
+#include "LogUtils.h"
+#include "VectorAllocator.h"
+#include "VectorCounters.h"
+#include "VectorParallel.h"
+#include "VectorSummation.h"
+
+using std::isinf;
+using std::isnan;
+
+namespace {
+
+	/*
+	 * Loops reading operand in its native precision, arithmetic is done in double
+	 */
+	template<class T>
+	void axpbyLoop(double* out, double alpha, const T* x, double beta, const float* y, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			out[i] = alpha * x[i] + beta * y[i];
+		}
+	}
+
+	template<class T>
+	void accumulateLoop(double* acc, double alpha, const T* x, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			acc[i] += alpha * x[i];
+		}
+	}
+
+	// out = alpha * op + beta * y over [begin, begin + len), out holds only the span
+	void axpbyRange(double* out, double alpha, const DenseSpan::DenseData& op, double beta, const float* y,
+					size_t begin, size_t len) {
+		if (op.floats) {
+			axpbyLoop(out, alpha, op.floats + begin, beta, y + begin, len);
+		} else {
+			axpbyLoop(out, alpha, op.doubles + begin, beta, y + begin, len);
+		}
+	}
+
+	template<class T>
+	size_t findOutOfRange(const T* data, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			if (!(std::fabs(data[i]) <= FLT_MAX)) {
+				return i;
+			}
+		}
+		return n;
+	}
+
+} // namespace
+
+const size_t FloatVector::BLOCK_SIZE;
+
+const size_t FloatVector::PAYLOAD_OFFSET =
+	(VectorAllocator::HEADER_SIZE + sizeof(FloatVector) + VectorAllocator::ALIGNMENT - 1) /
+		VectorAllocator::ALIGNMENT * VectorAllocator::ALIGNMENT -
+	VectorAllocator::HEADER_SIZE;
+
+FloatVector* FloatVector::allocate(size_t dim) {
+	FloatVector* vector = nullptr;
+	if (dim * sizeof(float) < VectorAllocator::SEPARATE_PAYLOAD_SIZE) {
+		auto mem = VectorAllocator::allocate(PAYLOAD_OFFSET + dim * sizeof(float));
+		vector = mem ? new (mem) FloatVector(dim) : nullptr;
+	} else {
+		auto mem = VectorAllocator::allocate(sizeof(FloatVector));
+		auto payload = mem ? VectorAllocator::allocatePayload(dim * sizeof(float)) : nullptr;
+		if (!payload) {
+			VectorAllocator::deallocate(mem);
+		} else {
+			vector = new (mem) FloatVector(dim, static_cast<float*>(payload));
+		}
+	}
+
+	if (!vector) {
+		log_warning(RC::ALLOCATION_ERROR);
+	}
+	return vector;
+}
+
+FloatVector* FloatVector::createVector(size_t dim, const double* data) {
+	count_operation(CREATE, dim);
+
+	auto vector = allocate(dim);
+	if (!vector) {
+		return nullptr;
+	}
+
+	if (vector->setData(dim, data) != RC::SUCCESS) {
+		delete vector;
+		return nullptr;
+	}
+
+	return vector;
+}
+
+FloatVector* FloatVector::createVector(size_t dim, const float* data) {
+	count_operation(CREATE, dim);
+
+	if (validateData(data, dim) != RC::SUCCESS) {
+		return nullptr;
+	}
+
+	auto vector = allocate(dim);
+	if (!vector) {
+		return nullptr;
+	}
+
+	memcpy(vector->m_data, data, dim * sizeof(float));
+	return vector;
+}
+
+void FloatVector::operator delete(void* ptr) { VectorAllocator::deallocate(ptr); }
+
+FloatVector::FloatVector(size_t dim) : m_dim(dim), m_isPayloadSeparate(false) {
+	auto* memBegin = reinterpret_cast<int8_t*>(this);
+	m_data = reinterpret_cast<float*>(memBegin + PAYLOAD_OFFSET);
+}
+
+FloatVector::FloatVector(size_t dim, float* payload) : m_dim(dim), m_data(payload), m_isPayloadSeparate(true) {}
+
+FloatVector::~FloatVector() {
+	if (m_isPayloadSeparate) {
+		VectorAllocator::deallocatePayload(m_data);
+	}
+}
+
+bool FloatVector::swapStorage(IVector* other) {
+	auto vector = dynamic_cast<FloatVector*>(other);
+	if (!vector || vector->m_dim != m_dim || !m_isPayloadSeparate || !vector->m_isPayloadSeparate) {
+		return false;
+	}
+
+	std::swap(m_data, vector->m_data);
+	return true;
+}
+
+IVector* IVector::createVector(size_t dim, double const* const& ptr_data, PRECISION precision) {
+	switch (precision) {
+	case PRECISION::DOUBLE:
+		return createVector(dim, ptr_data);
+
+	case PRECISION::FLOAT:
+		return FloatVector::createVector(dim, ptr_data);
+
+	default:
+		log_warning_in(getLogger(), RC::INVALID_ARGUMENT);
+		return nullptr;
+	}
+}
+
+IVector* IVector::createVector(size_t dim, float const* const& ptr_data) {
+	return FloatVector::createVector(dim, ptr_data);
+}
+
+RC FloatVector::validateData(const double* data, size_t dim) {
+	size_t index = findOutOfRange(data, dim);
+	if (index == dim) {
+		return RC::SUCCESS;
+	}
+
+	RC rc = isnan(data[index]) ? RC::NOT_NUMBER : RC::INFINITY_OVERFLOW;
+	log_warning(rc);
+	return rc;
+}
+
+RC FloatVector::validateData(const float* data, size_t dim) {
+	size_t index = findOutOfRange(data, dim);
+	if (index == dim) {
+		return RC::SUCCESS;
+	}
+
+	RC rc = isnan(data[index]) ? RC::NOT_NUMBER : RC::INFINITY_OVERFLOW;
+	log_warning(rc);
+	return rc;
+}
+
+template<class Update>
+RC FloatVector::updateBlocks(const Update& update, bool isParallel) {
+	// Smallest bad index packed with its kind as 2 * index + isNan, since the bad value itself is not stored
+	std::atomic<size_t> bad(2 * m_dim);
+	auto updateChunk = [&](size_t chunkBegin, size_t chunkLen) {
+		double block[BLOCK_SIZE];
+
+		for (size_t begin = chunkBegin; begin < chunkBegin + chunkLen; begin += BLOCK_SIZE) {
+			size_t len = std::min(BLOCK_SIZE, chunkBegin + chunkLen - begin);
+
+			update(block, begin, len);
+
+			// Narrowing a value out of float range is undefined, so it is checked in double
+			size_t found = findOutOfRange(block, len);
+			if (found != len) {
+				size_t code = 2 * (begin + found) + (isnan(block[found]) ? 1 : 0);
+				size_t current = bad.load();
+				while (code < current && !bad.compare_exchange_weak(current, code)) {
+				}
+				return;
+			}
+
+			for (size_t i = 0; i < len; i++) {
+				m_data[begin + i] = static_cast<float>(block[i]);
+			}
+		}
+	};
+
+	if (isParallel) {
+		VectorParallel::apply(m_dim, updateChunk);
+	} else {
+		updateChunk(0, m_dim);
+	}
+
+	if (bad == 2 * m_dim) {
+		return RC::SUCCESS;
+	}
+
+	RC rc = bad % 2 == 1 ? RC::NOT_NUMBER : RC::INFINITY_OVERFLOW;
+	log_warning(rc);
+	return rc;
+}
+
+IVector* FloatVector::clone() const {
+	count_operation(CLONE, m_dim);
+	return FloatVector::createVector(m_dim, m_data);
+}
+
+// Coordinates are kept only as float, they are read by getFloatData, getCoord or foreach
+double const* FloatVector::getData() const { return nullptr; }
+
+RC FloatVector::setData(size_t dim, double const* const& data) {
+	count_operation(SET_DATA, m_dim);
+
+	if (dim != m_dim) {
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	// Source is checked before converting, so invalid data leaves the vector untouched
+	RC rc = validateData(data, dim);
+	if (rc != RC::SUCCESS) {
+		return rc;
+	}
+
+	for (size_t i = 0; i < dim; i++) {
+		m_data[i] = static_cast<float>(data[i]);
+	}
+	return RC::SUCCESS;
+}
+
+IVector::PRECISION FloatVector::getPrecision() const { return PRECISION::FLOAT; }
+
+float const* FloatVector::getFloatData() const { return m_data; }
+
+size_t FloatVector::getNonZeroCount() const { return m_dim; }
+
+size_t const* FloatVector::getNonZeroIndices() const { return nullptr; }
+
+double const* FloatVector::getNonZeroValues() const { return nullptr; }
+
+RC FloatVector::getCoord(size_t index, double& val) const {
+	if (index >= m_dim) {
+		return RC::INDEX_OUT_OF_BOUND;
+	}
+
+	val = m_data[index];
+	return RC::SUCCESS;
+}
+
+RC FloatVector::setCoord(size_t index, double val) {
+	if (index >= m_dim) {
+		log_warning(RC::INDEX_OUT_OF_BOUND);
+		return RC::INDEX_OUT_OF_BOUND;
+	}
+
+	RC rc = validateData(&val, 1);
+	if (rc != RC::SUCCESS) {
+		return rc;
+	}
+
+	m_data[index] = static_cast<float>(val);
+	return RC::SUCCESS;
+}
+
+size_t FloatVector::getDim() const { return m_dim; }
+
+RC FloatVector::scale(double multiplier) {
+	count_operation(SCALE, m_dim);
+
+	if (isnan(multiplier) || isinf(multiplier)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		for (size_t i = 0; i < len; i++) {
+			block[i] = multiplier * m_data[begin + i];
+		}
+	}, true);
+}
+
+RC FloatVector::inc(IVector const* const& op) { return axpy(1.0, op); }
+
+RC FloatVector::dec(IVector const* const& op) { return axpy(-1.0, op); }
+
+RC FloatVector::axpy(double alpha, IVector const* const& op) { return axpby(alpha, op, 1.0); }
+
+RC FloatVector::axpby(double alpha, IVector const* const& op, double beta) {
+	count_operation(UPDATE, m_dim);
+
+	if (isnan(alpha) || isinf(alpha) || isnan(beta) || isinf(beta)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	if (m_dim != op->getDim()) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	// Sparse operand fills its dense mirror, which may fail
+	DenseSpan::DenseData dense;
+	if (!DenseSpan::getDense(op, dense)) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		axpbyRange(block, alpha, dense, beta, m_data, begin, len);
+	}, true);
+}
+
+RC FloatVector::linearCombination(size_t count, double const* coeffs, IVector const* const* ops) {
+	count_operation(LINEAR_COMBINATION, m_dim);
+
+	if (!coeffs || !ops) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	for (size_t k = 0; k < count; k++) {
+		if (!ops[k]) {
+			log_severe(RC::NULLPTR_ERROR);
+			return RC::NULLPTR_ERROR;
+		}
+
+		if (ops[k]->getDim() != m_dim) {
+			log_warning(RC::MISMATCHING_DIMENSIONS);
+			return RC::MISMATCHING_DIMENSIONS;
+		}
+
+		if (isnan(coeffs[k]) || isinf(coeffs[k])) {
+			log_warning(RC::INVALID_ARGUMENT);
+			return RC::INVALID_ARGUMENT;
+		}
+
+		DenseSpan::DenseData dense;
+		if (!DenseSpan::getDense(ops[k], dense)) {
+			return RC::ALLOCATION_ERROR;
+		}
+	}
+
+	// Blocks are accumulated in double on stack, so this can be one of ops and rounding happens once
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		std::fill(block, block + len, 0.0);
+		for (size_t k = 0; k < count; k++) {
+			DenseSpan::DenseData dense;
+			DenseSpan::getDense(ops[k], dense);
+			if (dense.floats) {
+				accumulateLoop(block, coeffs[k], dense.floats + begin, len);
+			} else {
+				accumulateLoop(block, coeffs[k], dense.doubles + begin, len);
+			}
+		}
+	}, false);
+}
+
+double FloatVector::norm(NORM n) const {
+	count_operation(NORM, m_dim);
+
+	double res = NAN;
+
+	switch (n) {
+	case NORM::FIRST:
+		res = VectorParallel::reduceSum(m_dim, [&](size_t begin, size_t len) {
+			const float* data = m_data + begin;
+			return VectorSummation::sum(len, [data](size_t blockBegin, size_t blockLen) {
+				double sum = 0;
+				for (size_t i = blockBegin; i < blockBegin + blockLen; i++) {
+					sum += std::fabs(double(data[i]));
+				}
+				return sum;
+			}, [data](size_t i) { return std::fabs(double(data[i])); });
+		});
+		break;
+
+	case NORM::SECOND:
+		res = sqrt(VectorParallel::reduceSum(m_dim, [&](size_t begin, size_t len) {
+			const float* data = m_data + begin;
+			return VectorSummation::sum(len, [data](size_t blockBegin, size_t blockLen) {
+				double sum = 0;
+				for (size_t i = blockBegin; i < blockBegin + blockLen; i++) {
+					sum += double(data[i]) * data[i];
+				}
+				return sum;
+			}, [data](size_t i) { return double(data[i]) * data[i]; });
+		}));
+		break;
+
+	case NORM::CHEBYSHEV:
+		res = VectorParallel::reduceMax(m_dim, [&](size_t begin, size_t len) {
+			double max = 0;
+			for (size_t i = begin; i < begin + len; i++) {
+				max = std::max(max, std::fabs(double(m_data[i])));
+			}
+			return max;
+		});
+		break;
+
+	default:
+		log_severe(RC::UNKNOWN);
+		return res;
+	}
+
+	if (isinf(res)) {
+		log_warning(RC::INFINITY_OVERFLOW);
+	}
+
+	return res;
+}
+
+RC FloatVector::applyFunction(const std::function<double(double)>& fun) {
+	count_operation(APPLY, m_dim);
+
+	// Coordinates are passed to fun in order, so blocks are not split between threads
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		for (size_t i = 0; i < len; i++) {
+			block[i] = fun(m_data[begin + i]);
+		}
+	}, false);
+}
+
+RC FloatVector::foreach (const std::function<void(double)>& fun) const {
+	count_operation(FOREACH, m_dim);
+
+	for (size_t i = 0; i < m_dim; i++) {
+		fun(m_data[i]);
+	}
+	return RC::SUCCESS;
+}
+
+RC FloatVector::applyBlockFunction(const BlockFunction& fun) {
+	count_operation(APPLY, m_dim);
+
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		std::copy(m_data + begin, m_data + begin + len, block);
+		fun(block, block, len);
+	}, false);
+}
+
+RC FloatVector::foreachBlock(const ConstBlockFunction& fun) const {
+	count_operation(FOREACH, m_dim);
+
+	double block[BLOCK_SIZE];
+
+	for (size_t begin = 0; begin < m_dim; begin += BLOCK_SIZE) {
+		size_t len = std::min(BLOCK_SIZE, m_dim - begin);
+
+		std::copy(m_data + begin, m_data + begin + len, block);
+		fun(block, len);
+	}
+	return RC::SUCCESS;
+}
+
+size_t FloatVector::sizeAllocated() const {
+	return (m_isPayloadSeparate ? sizeof(FloatVector) : PAYLOAD_OFFSET) + m_dim * sizeof(float);
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <IVector.h>
+
+namespace {
+
+	/*
+	 * Vector storing coordinates as float
+	 *
+	 * Arithmetic is done in double and rounded once on store, reductions are accumulated in double.
+	 * Operands of any precision are read natively. There are no double coordinates, getData returns nullptr
+	 */
+	class FloatVector : public IVector {
+	public:
+		IVector* clone() const override;
+		double const* getData() const override;
+		RC setData(size_t dim, double const* const& data) override;
+
+		PRECISION getPrecision() const override;
+		float const* getFloatData() const override;
+
+		size_t getNonZeroCount() const override;
+		size_t const* getNonZeroIndices() const override;
+		double const* getNonZeroValues() const override;
+
+		RC getCoord(size_t index, double& val) const override;
+		RC setCoord(size_t index, double val) override;
+		RC scale(double multiplier) override;
+		size_t getDim() const override;
+
+		RC inc(IVector const* const& op) override;
+		RC dec(IVector const* const& op) override;
+
+		RC axpy(double alpha, IVector const* const& op) override;
+		RC axpby(double alpha, IVector const* const& op, double beta) override;
+		RC linearCombination(size_t count, double const* coeffs, IVector const* const* ops) override;
+
+		double norm(NORM n) const override;
+
+		RC applyFunction(const std::function<double(double)>& fun) override;
+		RC foreach (const std::function<void(double)>& fun) const override;
+
+		RC applyBlockFunction(const BlockFunction& fun) override;
+		RC foreachBlock(const ConstBlockFunction& fun) const override;
+
+		size_t sizeAllocated() const override;
+
+		static FloatVector* createVector(size_t dim, const double* data);
+		static FloatVector* createVector(size_t dim, const float* data);
+
+		static void operator delete(void* ptr);
+
+		~FloatVector() override;
+
+	private:
+		// Coordinates right after the object
+		explicit FloatVector(size_t dim);
+		// Coordinates in a block of their own, owned by the vector
+		FloatVector(size_t dim, float* payload);
+
+		static FloatVector* allocate(size_t dim);
+
+		bool swapStorage(IVector* other) override;
+
+		/*
+		 * Checks that every value fits into float range, logs once for the first bad one
+		 */
+		static RC validateData(const double* data, size_t dim);
+		static RC validateData(const float* data, size_t dim);
+
+		/*
+		 * update(block, begin, len) writes new values of a span in double, they are range checked before
+		 * narrowing and the span is stored only if all of them fit into float. Spans before the failed one,
+		 * and in parallel also ones of other chunks, keep their new values
+		 */
+		template<class Update>
+		RC updateBlocks(const Update& update, bool isParallel);
+
+		// Double block size used to convert coordinates on stack
+		static const size_t BLOCK_SIZE = 256;
+
+		// Distance from the object to its 64 byte aligned coordinates
+		static const size_t PAYLOAD_OFFSET;
+
+		size_t m_dim;
+		float* m_data;
+		bool m_isPayloadSeparate;
+	};
+
+} // namespace
@@ -0,0 +1,147 @@
+#include <cmath>
+
+#include "SparseKernels.h"
+#include "VectorSummation.h"
+
+using SparseKernels::SparseData;
+
+namespace {
+
+	class DistanceAccumulator {
+	public:
+		explicit DistanceAccumulator(IVector::NORM n) : m_norm(n) {}
+
+		void add(double diff) {
+			switch (m_norm) {
+			case IVector::NORM::FIRST:
+				m_res += std::fabs(diff);
+				break;
+
+			case IVector::NORM::SECOND:
+				m_res += diff * diff;
+				break;
+
+			// NaN difference is kept, so that it never compares below a limit
+			default: {
+				double d = std::fabs(diff);
+				if (!(d <= m_res)) {
+					m_res = d;
+				}
+				break;
+			}
+			}
+		}
+
+		double result() const { return m_res; }
+
+	private:
+		IVector::NORM m_norm;
+		double m_res = 0;
+	};
+
+	template<class Accumulator>
+	double mergeDot(const SparseData& a, const SparseData& b) {
+		Accumulator acc;
+		size_t i = 0;
+		size_t j = 0;
+
+		while (i < a.nnz && j < b.nnz) {
+			if (a.indices[i] < b.indices[j]) {
+				i++;
+			} else if (b.indices[j] < a.indices[i]) {
+				j++;
+			} else {
+				acc.add(a.values[i++] * b.values[j++]);
+			}
+		}
+		return acc.result();
+	}
+
+	template<class T>
+	double sparseDot(const SparseData& a, const T* b) {
+		auto term = [&](size_t k) { return a.values[k] * b[a.indices[k]]; };
+		return VectorSummation::sum(a.nnz, [&](size_t begin, size_t len) {
+			double sum = 0;
+			for (size_t k = begin; k < begin + len; k++) {
+				sum += term(k);
+			}
+			return sum;
+		}, term);
+	}
+
+	template<class T>
+	double sparseDistance(IVector::NORM n, const SparseData& a, const T* b, size_t dim, double limit) {
+		DistanceAccumulator acc(n);
+		size_t k = 0;
+
+		for (size_t i = 0; i < dim && acc.result() < limit; i++) {
+			double value = 0;
+			if (k < a.nnz && a.indices[k] == i) {
+				value = a.values[k++];
+			}
+			acc.add(value - b[i]);
+		}
+		return acc.result();
+	}
+
+} // namespace
+
+bool SparseKernels::getSparse(const IVector* vec, SparseData& sparse) {
+	sparse.indices = vec->getNonZeroIndices();
+	if (!sparse.indices) {
+		return false;
+	}
+
+	sparse.values = vec->getNonZeroValues();
+	sparse.nnz = vec->getNonZeroCount();
+	return true;
+}
+
+double SparseKernels::dot(const SparseData& a, const DenseSpan::DenseData& b) {
+	return b.doubles ? sparseDot(a, b.doubles) : sparseDot(a, b.floats);
+}
+
+double SparseKernels::dot(const SparseData& a, const SparseData& b) {
+	// Products of matching indices come out of the merge one by one
+	if (VectorSummation::getMode() == VectorSummation::Mode::COMPENSATED) {
+		return mergeDot<VectorSummation::Accumulator>(a, b);
+	}
+	return mergeDot<VectorSummation::PairwiseAccumulator>(a, b);
+}
+
+void SparseKernels::axpy(double* y, double alpha, const SparseData& x) {
+	for (size_t k = 0; k < x.nnz; k++) {
+		y[x.indices[k]] += alpha * x.values[k];
+	}
+}
+
+size_t SparseKernels::findNonFinite(const double* y, double alpha, const SparseData& x) {
+	for (size_t k = 0; k < x.nnz; k++) {
+		if (!std::isfinite(y[x.indices[k]] + alpha * x.values[k])) {
+			return k;
+		}
+	}
+	return x.nnz;
+}
+
+double SparseKernels::distance(IVector::NORM n, const SparseData& a, const DenseSpan::DenseData& b, size_t dim,
+							   double limit) {
+	return b.doubles ? sparseDistance(n, a, b.doubles, dim, limit) : sparseDistance(n, a, b.floats, dim, limit);
+}
+
+double SparseKernels::distance(IVector::NORM n, const SparseData& a, const SparseData& b, double limit) {
+	DistanceAccumulator acc(n);
+	size_t i = 0;
+	size_t j = 0;
+
+	while ((i < a.nnz || j < b.nnz) && acc.result() < limit) {
+		if (j == b.nnz || (i < a.nnz && a.indices[i] < b.indices[j])) {
+			acc.add(a.values[i++]);
+		} else if (i == a.nnz || b.indices[j] < a.indices[i]) {
+			acc.add(b.values[j++]);
+		} else {
+			acc.add(a.values[i++] - b.values[j++]);
+		}
+	}
+	return acc.result();
+}
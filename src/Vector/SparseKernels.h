@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+#include <IVector.h>
+
+#include "DenseSpan.h"
+
+/*
+ * Loops over sorted index/value pairs of sparse vectors, alone or together with dense coordinates
+ */
+namespace SparseKernels {
+
+	struct SparseData {
+		const size_t* indices;
+		const double* values;
+		size_t nnz;
+	};
+
+	/*
+	 * Returns false for dense vectors
+	 */
+	bool getSparse(const IVector* vec, SparseData& sparse);
+
+	// Sum of a.values[k] * b[a.indices[k]], dense coordinates are read in their native precision
+	double dot(const SparseData& a, const DenseSpan::DenseData& b);
+	double dot(const SparseData& a, const SparseData& b);
+
+	// y[x.indices[k]] += alpha * x.values[k]
+	void axpy(double* y, double alpha, const SparseData& x);
+
+	// Position in x of the first index where axpy would make y NaN or infinite, x.nnz if there is none
+	size_t findNonFinite(const double* y, double alpha, const SparseData& x);
+
+	/*
+	 * Distance between vectors in norm n, squared for SECOND one. Same as VectorKernels diff kernels,
+	 * stops as soon as the partial result reaches limit
+	 */
+	double distance(IVector::NORM n, const SparseData& a, const DenseSpan::DenseData& b, size_t dim,
+					double limit);
+	double distance(IVector::NORM n, const SparseData& a, const SparseData& b, double limit);
+
+} // namespace SparseKernels
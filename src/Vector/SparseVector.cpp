@@ -0,0 +1,576 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "DenseSpan.h"
+#include "LogUtils.h"
+#include "SparseVector.h"
+#include "VectorAllocator.h"
+#include "VectorCounters.h"
+#include "VectorKernels.h"
+#include "VectorSummation.h"
+
+using SparseKernels::SparseData;
+using std::isinf;
+using std::isnan;
+
+namespace {
+
+	/*
+	 * Single finiteness scan, logs once for the first bad value
+	 */
+	RC validateValues(const double* values, size_t n) {
+		size_t index = VectorKernels::active().findNonFinite(values, n);
+		if (index == n) {
+			return RC::SUCCESS;
+		}
+
+		RC rc = isnan(values[index]) ? RC::NOT_NUMBER : RC::INFINITY_OVERFLOW;
+		log_warning_in(IVector::getLogger(), rc);
+		return rc;
+	}
+
+} // namespace
+
+const size_t SparseVector::BLOCK_SIZE;
+
+SparseVector* SparseVector::createVector(size_t dim, const double* data) {
+	count_operation(CREATE, dim);
+
+	auto mem = VectorAllocator::allocate(sizeof(SparseVector));
+	if (!mem) {
+		log_warning(RC::ALLOCATION_ERROR);
+		return nullptr;
+	}
+	auto vector = new (mem) SparseVector(dim);
+
+	if (vector->assign(data) != RC::SUCCESS) {
+		delete vector;
+		return nullptr;
+	}
+
+	return vector;
+}
+
+SparseVector* SparseVector::createVector(size_t dim, size_t nnz, const size_t* indices, const double* values) {
+	count_operation(CREATE, nnz);
+
+	if (nnz != 0 && (!indices || !values)) {
+		log_severe(RC::NULLPTR_ERROR);
+		return nullptr;
+	}
+
+	for (size_t k = 0; k < nnz; k++) {
+		if (indices[k] >= dim) {
+			log_warning(RC::INDEX_OUT_OF_BOUND);
+			return nullptr;
+		}
+
+		if (k != 0 && indices[k] <= indices[k - 1]) {
+			log_warning(RC::INVALID_ARGUMENT);
+			return nullptr;
+		}
+	}
+
+	if (validateValues(values, nnz) != RC::SUCCESS) {
+		return nullptr;
+	}
+
+	auto mem = VectorAllocator::allocate(sizeof(SparseVector));
+	if (!mem) {
+		log_warning(RC::ALLOCATION_ERROR);
+		return nullptr;
+	}
+	auto vector = new (mem) SparseVector(dim);
+
+	if (!vector->reserve(std::max(nnz, size_t(1)))) {
+		log_warning(RC::ALLOCATION_ERROR);
+		delete vector;
+		return nullptr;
+	}
+
+	for (size_t k = 0; k < nnz; k++) {
+		if (values[k] != 0) {
+			vector->m_indices[vector->m_nnz] = indices[k];
+			vector->m_values[vector->m_nnz] = values[k];
+			vector->m_nnz++;
+		}
+	}
+
+	return vector;
+}
+
+void SparseVector::operator delete(void* ptr) { VectorAllocator::deallocate(ptr); }
+
+SparseVector::SparseVector(size_t dim) : m_dim(dim) {}
+
+SparseVector::~SparseVector() {
+	delete[] m_indices;
+	delete[] m_values;
+	delete[] m_mirror;
+}
+
+bool SparseVector::swapStorage(IVector* other) {
+	auto vector = dynamic_cast<SparseVector*>(other);
+	if (!vector || vector->m_dim != m_dim) {
+		return false;
+	}
+
+	std::swap(m_nnz, vector->m_nnz);
+	std::swap(m_capacity, vector->m_capacity);
+	std::swap(m_indices, vector->m_indices);
+	std::swap(m_values, vector->m_values);
+	std::swap(m_mirror, vector->m_mirror);
+	std::swap(m_isMirrorValid, vector->m_isMirrorValid);
+	return true;
+}
+
+IVector* IVector::createSparseVector(size_t dim, double const* const& ptr_data) {
+	return SparseVector::createVector(dim, ptr_data);
+}
+
+IVector* IVector::createSparseVector(size_t dim, size_t nnz, size_t const* indices, double const* values) {
+	return SparseVector::createVector(dim, nnz, indices, values);
+}
+
+bool SparseVector::reserve(size_t capacity) {
+	if (capacity <= m_capacity) {
+		return true;
+	}
+
+	auto indices = new (std::nothrow) size_t[capacity];
+	auto values = new (std::nothrow) double[capacity];
+	if (!indices || !values) {
+		delete[] indices;
+		delete[] values;
+		return false;
+	}
+	count_allocation(capacity * sizeof(size_t));
+	count_allocation(capacity * sizeof(double));
+
+	std::copy(m_indices, m_indices + m_nnz, indices);
+	std::copy(m_values, m_values + m_nnz, values);
+	delete[] m_indices;
+	delete[] m_values;
+
+	m_indices = indices;
+	m_values = values;
+	m_capacity = capacity;
+	return true;
+}
+
+RC SparseVector::assign(const double* data) {
+	if (!data && m_dim != 0) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	RC rc = validateValues(data, m_dim);
+	if (rc != RC::SUCCESS) {
+		return rc;
+	}
+
+	// Index array always exists, it tells sparse vectors apart from dense ones
+	size_t nnz = m_dim - std::count(data, data + m_dim, 0.0);
+	if (!reserve(std::max(nnz, size_t(1)))) {
+		log_warning(RC::ALLOCATION_ERROR);
+		return RC::ALLOCATION_ERROR;
+	}
+
+	invalidateMirror();
+	m_nnz = 0;
+	for (size_t i = 0; i < m_dim; i++) {
+		if (data[i] != 0) {
+			m_indices[m_nnz] = i;
+			m_values[m_nnz] = data[i];
+			m_nnz++;
+		}
+	}
+	return RC::SUCCESS;
+}
+
+RC SparseVector::merge(double alpha, const SparseData& op, double beta) {
+	size_t capacity = std::max(m_nnz + op.nnz, size_t(1));
+	auto indices = new (std::nothrow) size_t[capacity];
+	auto values = new (std::nothrow) double[capacity];
+	if (!indices || !values) {
+		delete[] indices;
+		delete[] values;
+		log_warning(RC::ALLOCATION_ERROR);
+		return RC::ALLOCATION_ERROR;
+	}
+	count_allocation(capacity * sizeof(size_t));
+	count_allocation(capacity * sizeof(double));
+
+	// op may be this vector, so result goes to new arrays
+	size_t nnz = 0;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < m_nnz || j < op.nnz) {
+		size_t index;
+		double value;
+
+		if (j == op.nnz || (i < m_nnz && m_indices[i] < op.indices[j])) {
+			index = m_indices[i];
+			value = beta * m_values[i++];
+		} else if (i == m_nnz || op.indices[j] < m_indices[i]) {
+			index = op.indices[j];
+			value = alpha * op.values[j++];
+		} else {
+			index = m_indices[i];
+			value = alpha * op.values[j++] + beta * m_values[i++];
+		}
+
+		if (value != 0) {
+			indices[nnz] = index;
+			values[nnz] = value;
+			nnz++;
+		}
+	}
+
+	RC rc = validateValues(values, nnz);
+	if (rc != RC::SUCCESS) {
+		delete[] indices;
+		delete[] values;
+		return rc;
+	}
+
+	invalidateMirror();
+	delete[] m_indices;
+	delete[] m_values;
+
+	m_indices = indices;
+	m_values = values;
+	m_nnz = nnz;
+	m_capacity = capacity;
+	return RC::SUCCESS;
+}
+
+size_t SparseVector::find(size_t index) const {
+	return std::lower_bound(m_indices, m_indices + m_nnz, index) - m_indices;
+}
+
+void SparseVector::invalidateMirror() { m_isMirrorValid = false; }
+
+IVector* SparseVector::clone() const {
+	count_operation(CLONE, m_nnz);
+	return SparseVector::createVector(m_dim, m_nnz, m_indices, m_values);
+}
+
+double const* SparseVector::getData() const {
+	if (!m_mirror) {
+		m_mirror = new (std::nothrow) double[m_dim];
+		if (!m_mirror) {
+			log_warning(RC::ALLOCATION_ERROR);
+			return nullptr;
+		}
+		count_allocation(m_dim * sizeof(double));
+	}
+
+	if (!m_isMirrorValid) {
+		std::fill(m_mirror, m_mirror + m_dim, 0.0);
+		for (size_t k = 0; k < m_nnz; k++) {
+			m_mirror[m_indices[k]] = m_values[k];
+		}
+		m_isMirrorValid = true;
+	}
+
+	return m_mirror;
+}
+
+RC SparseVector::setData(size_t dim, double const* const& data) {
+	count_operation(SET_DATA, m_dim);
+
+	if (dim != m_dim) {
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	return assign(data);
+}
+
+IVector::PRECISION SparseVector::getPrecision() const { return PRECISION::DOUBLE; }
+
+float const* SparseVector::getFloatData() const { return nullptr; }
+
+size_t SparseVector::getNonZeroCount() const { return m_nnz; }
+
+size_t const* SparseVector::getNonZeroIndices() const { return m_indices; }
+
+double const* SparseVector::getNonZeroValues() const { return m_values; }
+
+RC SparseVector::getCoord(size_t index, double& val) const {
+	if (index >= m_dim) {
+		return RC::INDEX_OUT_OF_BOUND;
+	}
+
+	size_t pos = find(index);
+	val = pos < m_nnz && m_indices[pos] == index ? m_values[pos] : 0;
+	return RC::SUCCESS;
+}
+
+RC SparseVector::setCoord(size_t index, double val) {
+	if (index >= m_dim) {
+		log_warning(RC::INDEX_OUT_OF_BOUND);
+		return RC::INDEX_OUT_OF_BOUND;
+	}
+
+	RC rc = validateValues(&val, 1);
+	if (rc != RC::SUCCESS) {
+		return rc;
+	}
+
+	size_t pos = find(index);
+	bool isStored = pos < m_nnz && m_indices[pos] == index;
+
+	if (isStored && val != 0) {
+		m_values[pos] = val;
+
+	} else if (isStored) {
+		memmove(m_indices + pos, m_indices + pos + 1, (m_nnz - pos - 1) * sizeof(size_t));
+		memmove(m_values + pos, m_values + pos + 1, (m_nnz - pos - 1) * sizeof(double));
+		m_nnz--;
+
+	} else if (val != 0) {
+		if (m_nnz == m_capacity && !reserve(std::max(size_t(4), m_capacity * 2))) {
+			log_warning(RC::ALLOCATION_ERROR);
+			return RC::ALLOCATION_ERROR;
+		}
+
+		memmove(m_indices + pos + 1, m_indices + pos, (m_nnz - pos) * sizeof(size_t));
+		memmove(m_values + pos + 1, m_values + pos, (m_nnz - pos) * sizeof(double));
+		m_indices[pos] = index;
+		m_values[pos] = val;
+		m_nnz++;
+	}
+
+	invalidateMirror();
+	return RC::SUCCESS;
+}
+
+RC SparseVector::scale(double multiplier) {
+	count_operation(SCALE, m_nnz);
+
+	if (isnan(multiplier) || isinf(multiplier)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	// Products of finite values can only overflow, so the largest one is checked before any is written
+	double largest = 0;
+	for (size_t k = 0; k < m_nnz; k++) {
+		largest = std::max(largest, std::fabs(m_values[k]));
+	}
+
+	if (isinf(largest * multiplier)) {
+		log_warning(RC::INFINITY_OVERFLOW);
+		return RC::INFINITY_OVERFLOW;
+	}
+
+	invalidateMirror();
+	if (multiplier == 0) {
+		m_nnz = 0;
+		return RC::SUCCESS;
+	}
+
+	VectorKernels::active().scale(m_values, multiplier, m_nnz);
+	return RC::SUCCESS;
+}
+
+size_t SparseVector::getDim() const { return m_dim; }
+
+RC SparseVector::inc(IVector const* const& op) { return axpby(1.0, op, 1.0); }
+
+RC SparseVector::dec(IVector const* const& op) { return axpby(-1.0, op, 1.0); }
+
+RC SparseVector::axpy(double alpha, IVector const* const& op) { return axpby(alpha, op, 1.0); }
+
+RC SparseVector::axpby(double alpha, IVector const* const& op, double beta) {
+	count_operation(UPDATE, m_dim);
+
+	if (isnan(alpha) || isinf(alpha) || isnan(beta) || isinf(beta)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	if (m_dim != op->getDim()) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	SparseData sparse;
+	if (SparseKernels::getSparse(op, sparse)) {
+		return merge(alpha, sparse, beta);
+	}
+
+	// Dense operand fills the whole vector anyway
+	DenseSpan::DenseData dense;
+	if (!DenseSpan::getDense(op, dense)) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	std::vector<double> res(m_dim, 0.0);
+	for (size_t k = 0; k < m_nnz; k++) {
+		res[m_indices[k]] = beta * m_values[k];
+	}
+
+	auto& kernels = VectorKernels::active();
+	DenseSpan::forBlocks(dense, m_dim, [&](size_t begin, const double* opData, size_t len) {
+		kernels.axpy(res.data() + begin, alpha, opData, len);
+	});
+
+	return assign(res.data());
+}
+
+RC SparseVector::linearCombination(size_t count, double const* coeffs, IVector const* const* ops) {
+	count_operation(LINEAR_COMBINATION, m_dim);
+
+	if (!coeffs || !ops) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	for (size_t k = 0; k < count; k++) {
+		if (!ops[k]) {
+			log_severe(RC::NULLPTR_ERROR);
+			return RC::NULLPTR_ERROR;
+		}
+
+		if (ops[k]->getDim() != m_dim) {
+			log_warning(RC::MISMATCHING_DIMENSIONS);
+			return RC::MISMATCHING_DIMENSIONS;
+		}
+
+		if (isnan(coeffs[k]) || isinf(coeffs[k])) {
+			log_warning(RC::INVALID_ARGUMENT);
+			return RC::INVALID_ARGUMENT;
+		}
+	}
+
+	// Sparse operands are scattered, dense ones are added with the vector kernel
+	std::vector<double> res(m_dim, 0.0);
+	for (size_t k = 0; k < count; k++) {
+		SparseData sparse;
+		if (SparseKernels::getSparse(ops[k], sparse)) {
+			SparseKernels::axpy(res.data(), coeffs[k], sparse);
+			continue;
+		}
+
+		DenseSpan::DenseData dense;
+		if (!DenseSpan::getDense(ops[k], dense)) {
+			return RC::ALLOCATION_ERROR;
+		}
+
+		auto& kernels = VectorKernels::active();
+		DenseSpan::forBlocks(dense, m_dim, [&](size_t begin, const double* opData, size_t len) {
+			kernels.axpy(res.data() + begin, coeffs[k], opData, len);
+		});
+	}
+
+	return assign(res.data());
+}
+
+double SparseVector::norm(NORM n) const {
+	count_operation(NORM, m_nnz);
+
+	auto& kernels = VectorKernels::active();
+	double res = NAN;
+
+	switch (n) {
+	case NORM::FIRST:
+		res = VectorSummation::absSum(m_values, m_nnz);
+		break;
+
+	case NORM::SECOND:
+		res = sqrt(VectorSummation::squareSum(m_values, m_nnz));
+		break;
+
+	case NORM::CHEBYSHEV:
+		res = kernels.absMax(m_values, m_nnz);
+		break;
+
+	default:
+		log_severe(RC::UNKNOWN);
+		return res;
+	}
+
+	if (isinf(res)) {
+		log_warning(RC::INFINITY_OVERFLOW);
+	}
+
+	return res;
+}
+
+RC SparseVector::applyFunction(const std::function<double(double)>& fun) {
+	count_operation(APPLY, m_dim);
+
+	std::vector<double> res(m_dim);
+
+	size_t k = 0;
+	for (size_t i = 0; i < m_dim; i++) {
+		double value = 0;
+		if (k < m_nnz && m_indices[k] == i) {
+			value = m_values[k++];
+		}
+		res[i] = fun(value);
+	}
+
+	return assign(res.data());
+}
+
+RC SparseVector::foreach (const std::function<void(double)>& fun) const {
+	count_operation(FOREACH, m_dim);
+
+	size_t k = 0;
+	for (size_t i = 0; i < m_dim; i++) {
+		double value = 0;
+		if (k < m_nnz && m_indices[k] == i) {
+			value = m_values[k++];
+		}
+		fun(value);
+	}
+	return RC::SUCCESS;
+}
+
+RC SparseVector::applyBlockFunction(const BlockFunction& fun) {
+	count_operation(APPLY, m_dim);
+
+	const double* data = getData();
+	if (!data) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	std::vector<double> res(data, data + m_dim);
+	for (size_t begin = 0; begin < m_dim; begin += BLOCK_SIZE) {
+		size_t len = std::min(BLOCK_SIZE, m_dim - begin);
+		fun(res.data() + begin, res.data() + begin, len);
+	}
+
+	return assign(res.data());
+}
+
+RC SparseVector::foreachBlock(const ConstBlockFunction& fun) const {
+	count_operation(FOREACH, m_dim);
+
+	double block[BLOCK_SIZE];
+
+	size_t k = 0;
+	for (size_t begin = 0; begin < m_dim; begin += BLOCK_SIZE) {
+		size_t len = std::min(BLOCK_SIZE, m_dim - begin);
+
+		std::fill(block, block + len, 0.0);
+		for (; k < m_nnz && m_indices[k] < begin + len; k++) {
+			block[m_indices[k] - begin] = m_values[k];
+		}
+		fun(block, len);
+	}
+	return RC::SUCCESS;
+}
+
+size_t SparseVector::sizeAllocated() const {
+	size_t size = sizeof(SparseVector) + m_capacity * (sizeof(size_t) + sizeof(double));
+	if (m_mirror) {
+		size += m_dim * sizeof(double);
+	}
+	return size;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <IVector.h>
+
+#include "SparseKernels.h"
+
+namespace {
+
+	/*
+	 * Vector storing only nonzero coordinates as index/value pairs sorted by index
+	 *
+	 * Norms and updates by sparse operands cost O(nnz), updates by dense operands and elementwise
+	 * functions have to visit every coordinate. Dense coordinates are materialized only by getData
+	 */
+	class SparseVector : public IVector {
+	public:
+		IVector* clone() const override;
+		double const* getData() const override;
+		RC setData(size_t dim, double const* const& data) override;
+
+		PRECISION getPrecision() const override;
+		float const* getFloatData() const override;
+
+		size_t getNonZeroCount() const override;
+		size_t const* getNonZeroIndices() const override;
+		double const* getNonZeroValues() const override;
+
+		RC getCoord(size_t index, double& val) const override;
+		RC setCoord(size_t index, double val) override;
+		RC scale(double multiplier) override;
+		size_t getDim() const override;
+
+		RC inc(IVector const* const& op) override;
+		RC dec(IVector const* const& op) override;
+
+		RC axpy(double alpha, IVector const* const& op) override;
+		RC axpby(double alpha, IVector const* const& op, double beta) override;
+		RC linearCombination(size_t count, double const* coeffs, IVector const* const* ops) override;
+
+		double norm(NORM n) const override;
+
+		RC applyFunction(const std::function<double(double)>& fun) override;
+		RC foreach (const std::function<void(double)>& fun) const override;
+
+		RC applyBlockFunction(const BlockFunction& fun) override;
+		RC foreachBlock(const ConstBlockFunction& fun) const override;
+
+		size_t sizeAllocated() const override;
+
+		static SparseVector* createVector(size_t dim, const double* data);
+		static SparseVector* createVector(size_t dim, size_t nnz, const size_t* indices, const double* values);
+
+		static void operator delete(void* ptr);
+
+		~SparseVector() override;
+
+	private:
+		explicit SparseVector(size_t dim);
+
+		bool reserve(size_t capacity);
+
+		bool swapStorage(IVector* other) override;
+
+		/*
+		 * Replaces pairs with nonzero coordinates of dense data, invalid data leaves the vector untouched
+		 */
+		RC assign(const double* data);
+
+		/*
+		 * Replaces pairs with alpha * op + beta * this merged in a single pass
+		 */
+		RC merge(double alpha, const SparseKernels::SparseData& op, double beta);
+
+		// Position of index in m_indices or of the first greater one
+		size_t find(size_t index) const;
+
+		// Called by every modification
+		void invalidateMirror();
+
+		// Dense block size used by block functions
+		static const size_t BLOCK_SIZE = 1024;
+
+		size_t m_dim;
+		size_t m_nnz = 0;
+		size_t m_capacity = 0;
+
+		size_t* m_indices = nullptr;
+		double* m_values = nullptr;
+
+		mutable double* m_mirror = nullptr;
+		mutable bool m_isMirrorValid = false;
+	};
+
+} // namespace
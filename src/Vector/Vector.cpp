@@ -1,29 +1,109 @@
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
 #include <cmath>
 #include <cstring>
 
+#include "DenseSpan.h"
+#include "FixedVector.h"
 #include "Vector.h"
+#include "VectorAllocator.h"
+#include "VectorCounters.h"
+#include "VectorKernels.h"
+#include "VectorParallel.h"
+#include "VectorSummation.h"
 #include "VectorUtils.h"
 
 using std::isinf;
 using std::isnan;
 
+// Object starts HEADER_SIZE bytes past a cache line boundary, coordinates start on the next boundary
+const size_t Vector::PAYLOAD_OFFSET =
+	(VectorAllocator::HEADER_SIZE + sizeof(Vector) + VectorAllocator::ALIGNMENT - 1) /
+		VectorAllocator::ALIGNMENT * VectorAllocator::ALIGNMENT -
+	VectorAllocator::HEADER_SIZE;
+
+const size_t Vector::BLOCK_SIZE;
+
 Vector* Vector::createVector(size_t dim, double const* const& data) {
-	size_t size = sizeof(Vector) + dim * sizeof(double);
-	auto mem = new (std::nothrow) uint8_t[size];
-	if (!mem) {
+	count_operation(CREATE, dim);
+
+	switch (dim) {
+	case 2:
+		return FixedVector<2>::createVector(data);
+	case 3:
+		return FixedVector<3>::createVector(data);
+	case 4:
+		return FixedVector<4>::createVector(data);
+	case 8:
+		return FixedVector<8>::createVector(data);
+	default:
+		break;
+	}
+
+	Vector* vector = nullptr;
+	if (dim * sizeof(double) < VectorAllocator::SEPARATE_PAYLOAD_SIZE) {
+		auto mem = VectorAllocator::allocate(PAYLOAD_OFFSET + dim * sizeof(double));
+		vector = mem ? new (mem) Vector(dim) : nullptr;
+	} else {
+		auto mem = VectorAllocator::allocate(sizeof(Vector));
+		auto payload = mem ? VectorAllocator::allocatePayload(dim * sizeof(double)) : nullptr;
+		if (!payload) {
+			VectorAllocator::deallocate(mem);
+		} else {
+			vector = new (mem) Vector(dim, static_cast<double*>(payload), STORAGE::SEPARATE);
+		}
+	}
+
+	if (!vector) {
 		log_warning(RC::ALLOCATION_ERROR);
 		return nullptr;
 	}
-	auto vector = new (mem) Vector(dim);
 
 	if (vector->setData(dim, data) != RC::SUCCESS) {
-		delete[] mem;
+		delete vector;
 		return nullptr;
 	}
 
 	return vector;
 }
 
+Vector* Vector::createView(size_t dim, double* data) {
+	count_operation(CREATE, dim);
+
+	if (!data && dim != 0) {
+		log_severe(RC::NULLPTR_ERROR);
+		return nullptr;
+	}
+
+	auto mem = VectorAllocator::allocate(sizeof(Vector));
+	if (!mem) {
+		log_warning(RC::ALLOCATION_ERROR);
+		return nullptr;
+	}
+
+	return new (mem) Vector(dim, data);
+}
+
+void Vector::operator delete(void* ptr) { VectorAllocator::deallocate(ptr); }
+
+Vector::~Vector() {
+	if (m_storage == STORAGE::SEPARATE) {
+		VectorAllocator::deallocatePayload(m_data);
+	}
+}
+
+bool Vector::swapStorage(IVector* other) {
+	auto vector = dynamic_cast<Vector*>(other);
+	if (!vector || vector->m_dim != m_dim || m_storage != STORAGE::SEPARATE ||
+		vector->m_storage != STORAGE::SEPARATE) {
+		return false;
+	}
+
+	std::swap(m_data, vector->m_data);
+	return true;
+}
+
 RC IVector::setLogger(ILogger* const logger) {
 	return LogContainer<Vector>::setInstance(logger);
 }
@@ -32,66 +112,176 @@ ILogger* IVector::getLogger() {
 	return LogContainer<Vector>::getInstance();
 }
 
-IVector* Vector::clone() const { return Vector::createVector(m_dim, getData()); }
-
-const double* Vector::getData() const {
-	auto* memBegin = reinterpret_cast<const int8_t*>(this);
-	auto* dataBegin = memBegin + sizeof(Vector);
-	return reinterpret_cast<const double*>(dataBegin);
+RC IVector::setInstructionSet(INSTRUCTION_SET set) {
+	if (!VectorKernels::setActive(set)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+	return RC::SUCCESS;
 }
 
-double* Vector::getData() {
-	auto* memBegin = reinterpret_cast<int8_t*>(this);
-	auto* dataBegin = memBegin + sizeof(Vector);
-	return reinterpret_cast<double*>(dataBegin);
+IVector::INSTRUCTION_SET IVector::getInstructionSet() { return VectorKernels::activeSet(); }
+
+bool IVector::isInstructionSetSupported(INSTRUCTION_SET set) { return VectorKernels::get(set) != nullptr; }
+
+RC IVector::setParallelThreshold(size_t dim) {
+	VectorParallel::setThreshold(dim);
+	return RC::SUCCESS;
 }
 
-double Vector::infiniteNorm() const {
-	auto data = getData();
-	double norm = 0;
+size_t IVector::getParallelThreshold() { return VectorParallel::getThreshold(); }
 
-	for (size_t i = 0; i < m_dim; i++) {
-		norm = fmax(norm, fabs(data[i]));
+RC IVector::setMaxThreads(size_t count) {
+	if (count == 0) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
 	}
 
-	return norm;
+	VectorParallel::setMaxThreads(count);
+	return RC::SUCCESS;
+}
+
+size_t IVector::getMaxThreads() { return VectorParallel::getMaxThreads(); }
+
+IVector::PoolStatistics IVector::getPoolStatistics() { return VectorAllocator::getStatistics(); }
+
+RC IVector::trimPool() {
+	VectorAllocator::trim();
+	return RC::SUCCESS;
+}
+
+RC IVector::setPoolRetentionLimit(size_t bytes) {
+	VectorAllocator::setRetentionLimit(bytes);
+	return RC::SUCCESS;
+}
+
+IVector* Vector::clone() const {
+	count_operation(CLONE, m_dim);
+	return Vector::createVector(m_dim, getData());
+}
+
+const double* Vector::getData() const { return m_data; }
+
+double* Vector::getData() { return m_data; }
+
+IVector::PRECISION Vector::getPrecision() const { return PRECISION::DOUBLE; }
+
+float const* Vector::getFloatData() const { return nullptr; }
+
+size_t Vector::getNonZeroCount() const { return m_dim; }
+
+size_t const* Vector::getNonZeroIndices() const { return nullptr; }
+
+double const* Vector::getNonZeroValues() const { return nullptr; }
+
+
+double Vector::infiniteNorm() const {
+	auto& kernels = VectorKernels::active();
+	const double* data = getData();
+
+	return VectorParallel::reduceMax(m_dim, [&](size_t begin, size_t len) {
+		return kernels.absMax(data + begin, len);
+	});
 }
 
 double Vector::firstNorm() const {
-	auto data = getData();
-	double norm = 0;
+	const double* data = getData();
 
-	for (size_t i = 0; i < m_dim; i++) {
-		norm += fabs(data[i]);
+	return VectorParallel::reduceSum(m_dim, [&](size_t begin, size_t len) {
+		return VectorSummation::absSum(data + begin, len);
+	});
+}
+
+double Vector::secondNorm() const {
+	const double* data = getData();
+
+	return sqrt(VectorParallel::reduceSum(m_dim, [&](size_t begin, size_t len) {
+		return VectorSummation::squareSum(data + begin, len);
+	}));
+}
+
+RC Vector::validateData(const double* data, size_t dim) {
+	auto& kernels = VectorKernels::active();
+
+	// Smallest bad index among chunks, so the same coordinate is reported with any number of threads
+	std::atomic<size_t> index(dim);
+	VectorParallel::apply(dim, [&](size_t begin, size_t len) {
+		size_t found = kernels.findNonFinite(data + begin, len);
+		if (found == len) {
+			return;
+		}
+
+		size_t current = index.load();
+		while (begin + found < current && !index.compare_exchange_weak(current, begin + found)) {
+		}
+	});
+
+	if (index == dim) {
+		return RC::SUCCESS;
 	}
 
-	return norm;
+	RC rc = isnan(data[index]) ? RC::NOT_NUMBER : RC::INFINITY_OVERFLOW;
+	log_warning(rc);
+	return rc;
 }
 
-double Vector::secondNorm() const {
-	auto data = getData();
-	double norm = 0;
+template<class Update>
+RC Vector::updateBlocks(const Update& update, bool isParallel) {
+	auto& kernels = VectorKernels::active();
+	double* data = getData();
 
-	for (size_t i = 0; i < m_dim; i++) {
-		norm += pow(data[i], 2);
+	// Smallest bad index packed with its kind as 2 * index + isNan, since the bad value itself is not stored
+	std::atomic<size_t> bad(2 * m_dim);
+	auto updateChunk = [&](size_t chunkBegin, size_t chunkLen) {
+		double block[BLOCK_SIZE];
+
+		for (size_t begin = chunkBegin; begin < chunkBegin + chunkLen; begin += BLOCK_SIZE) {
+			size_t len = std::min(BLOCK_SIZE, chunkBegin + chunkLen - begin);
+
+			memcpy(block, data + begin, len * sizeof(double));
+			update(block, begin, len);
+
+			size_t found = kernels.findNonFinite(block, len);
+			if (found != len) {
+				size_t code = 2 * (begin + found) + (isnan(block[found]) ? 1 : 0);
+				size_t current = bad.load();
+				while (code < current && !bad.compare_exchange_weak(current, code)) {
+				}
+				return;
+			}
+			memcpy(data + begin, block, len * sizeof(double));
+		}
+	};
+
+	if (isParallel) {
+		VectorParallel::apply(m_dim, updateChunk);
+	} else {
+		updateChunk(0, m_dim);
+	}
+
+	if (bad == 2 * m_dim) {
+		return RC::SUCCESS;
 	}
 
-	return sqrt(norm);
+	RC rc = bad % 2 == 1 ? RC::NOT_NUMBER : RC::INFINITY_OVERFLOW;
+	log_warning(rc);
+	return rc;
 }
 
 RC Vector::setData(size_t dim, double const* const& data) {
+	count_operation(SET_DATA, m_dim);
 
 	if (dim != m_dim) {
 		return RC::MISMATCHING_DIMENSIONS;
 	}
 
-	for (size_t i = 0; i < dim; i++) {
-		RC rc = setCoord(i, data[i]);
-		if (rc != RC::SUCCESS) {
-			return rc;
-		}
+	// Source is checked before copying, so invalid data leaves the vector untouched
+	RC rc = validateData(data, dim);
+	if (rc != RC::SUCCESS) {
+		return rc;
 	}
 
+	memmove(getData(), data, dim * sizeof(double));
 	return RC::SUCCESS;
 }
 
@@ -127,56 +317,197 @@ RC Vector::setCoord(size_t index, double val) {
 }
 
 RC Vector::scale(double multiplier) {
+	count_operation(SCALE, m_dim);
 
 	if (isnan(multiplier) || isinf(multiplier)) {
 		log_warning(RC::INVALID_ARGUMENT);
 		return RC::INVALID_ARGUMENT;
 	}
 
-	auto multiply = [multiplier](double x) { return multiplier * x; };
-	return applyFunction(multiply);
+	auto& kernels = VectorKernels::active();
+
+	return updateBlocks([&](double* block, size_t, size_t len) { kernels.scale(block, multiplier, len); }, true);
 }
 
 size_t Vector::getDim() const { return m_dim; }
 
 RC Vector::inc(IVector const* const& op) {
+	count_operation(UPDATE, m_dim);
+
 	if (m_dim != op->getDim()) {
 		log_warning(RC::MISMATCHING_DIMENSIONS);
 		return RC::MISMATCHING_DIMENSIONS;
 	}
 
-	double* data = getData();
-	const double* opData = op->getData();
+	SparseKernels::SparseData sparse;
+	if (SparseKernels::getSparse(op, sparse)) {
+		return axpySparse(1.0, sparse);
+	}
 
-	for (size_t i = 0; i < m_dim; i++) {
-		RC rc = setCoord(i, data[i] + opData[i]);
-		if (rc != RC::SUCCESS) {
-			return rc;
-		}
+	DenseSpan::DenseData dense;
+	if (!DenseSpan::getDense(op, dense)) {
+		return RC::ALLOCATION_ERROR;
 	}
-	return RC::SUCCESS;
+
+	auto& kernels = VectorKernels::active();
+
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		double opBlock[BLOCK_SIZE];
+		kernels.add(block, DenseSpan::read(dense, begin, len, opBlock), len);
+	}, true);
 }
 
 RC Vector::dec(IVector const* const& op) {
+	count_operation(UPDATE, m_dim);
+
+	if (m_dim != op->getDim()) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	SparseKernels::SparseData sparse;
+	if (SparseKernels::getSparse(op, sparse)) {
+		return axpySparse(-1.0, sparse);
+	}
+
+	DenseSpan::DenseData dense;
+	if (!DenseSpan::getDense(op, dense)) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	auto& kernels = VectorKernels::active();
+
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		double opBlock[BLOCK_SIZE];
+		kernels.sub(block, DenseSpan::read(dense, begin, len, opBlock), len);
+	}, true);
+}
+
+RC Vector::axpy(double alpha, IVector const* const& op) {
+	count_operation(UPDATE, m_dim);
+
+	if (isnan(alpha) || isinf(alpha)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
 
 	if (m_dim != op->getDim()) {
 		log_warning(RC::MISMATCHING_DIMENSIONS);
 		return RC::MISMATCHING_DIMENSIONS;
 	}
 
+	SparseKernels::SparseData sparse;
+	if (SparseKernels::getSparse(op, sparse)) {
+		return axpySparse(alpha, sparse);
+	}
+
+	DenseSpan::DenseData dense;
+	if (!DenseSpan::getDense(op, dense)) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	auto& kernels = VectorKernels::active();
+
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		double opBlock[BLOCK_SIZE];
+		kernels.axpy(block, alpha, DenseSpan::read(dense, begin, len, opBlock), len);
+	}, true);
+}
+
+RC Vector::axpby(double alpha, IVector const* const& op, double beta) {
+	count_operation(UPDATE, m_dim);
+
+	if (isnan(alpha) || isinf(alpha) || isnan(beta) || isinf(beta)) {
+		log_warning(RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	if (m_dim != op->getDim()) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	SparseKernels::SparseData sparse;
+	if (SparseKernels::getSparse(op, sparse)) {
+		RC rc = beta == 1.0 ? RC::SUCCESS : scale(beta);
+		return rc == RC::SUCCESS ? axpySparse(alpha, sparse) : rc;
+	}
+
+	DenseSpan::DenseData dense;
+	if (!DenseSpan::getDense(op, dense)) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	auto& kernels = VectorKernels::active();
+
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		double opBlock[BLOCK_SIZE];
+		kernels.axpby(block, alpha, DenseSpan::read(dense, begin, len, opBlock), beta, len);
+	}, true);
+}
+
+RC Vector::axpySparse(double alpha, const SparseKernels::SparseData& op) {
 	double* data = getData();
-	const double* opData = op->getData();
 
-	for (size_t i = 0; i < m_dim; i++) {
-		RC rc = setCoord(i, data[i] - opData[i]);
-		if (rc != RC::SUCCESS) {
-			return rc;
+	// Only updated coordinates can become invalid, they are checked before any of them is written
+	size_t pos = SparseKernels::findNonFinite(data, alpha, op);
+	if (pos == op.nnz) {
+		SparseKernels::axpy(data, alpha, op);
+		return RC::SUCCESS;
+	}
+
+	RC rc = isnan(data[op.indices[pos]] + alpha * op.values[pos]) ? RC::NOT_NUMBER : RC::INFINITY_OVERFLOW;
+	log_warning(rc);
+	return rc;
+}
+
+RC Vector::linearCombination(size_t count, double const* coeffs, IVector const* const* ops) {
+	count_operation(LINEAR_COMBINATION, m_dim);
+
+	if (!coeffs || !ops) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	for (size_t k = 0; k < count; k++) {
+		if (!ops[k]) {
+			log_severe(RC::NULLPTR_ERROR);
+			return RC::NULLPTR_ERROR;
+		}
+
+		if (ops[k]->getDim() != m_dim) {
+			log_warning(RC::MISMATCHING_DIMENSIONS);
+			return RC::MISMATCHING_DIMENSIONS;
+		}
+
+		if (isnan(coeffs[k]) || isinf(coeffs[k])) {
+			log_warning(RC::INVALID_ARGUMENT);
+			return RC::INVALID_ARGUMENT;
+		}
+
+		DenseSpan::DenseData dense;
+		if (!DenseSpan::getDense(ops[k], dense)) {
+			return RC::ALLOCATION_ERROR;
 		}
 	}
-	return RC::SUCCESS;
+
+	auto& kernels = VectorKernels::active();
+
+	// Blocks are accumulated on stack, so this can be one of ops and every op is read once
+	return updateBlocks([&](double* block, size_t begin, size_t len) {
+		double opBlock[BLOCK_SIZE];
+		std::fill(block, block + len, 0.0);
+		for (size_t k = 0; k < count; k++) {
+			DenseSpan::DenseData dense;
+			DenseSpan::getDense(ops[k], dense);
+			kernels.axpy(block, coeffs[k], DenseSpan::read(dense, begin, len, opBlock), len);
+		}
+	}, false);
 }
 
 double Vector::norm(NORM n) const {
+	count_operation(NORM, m_dim);
+
 	double res = NAN;
 
 	switch (n) {
@@ -206,18 +537,19 @@ double Vector::norm(NORM n) const {
 }
 
 RC Vector::applyFunction(const std::function<double(double)>& fun) {
-	double* data = getData();
+	count_operation(APPLY, m_dim);
 
-	for (size_t i = 0; i < m_dim; i++) {
-		RC rc = setCoord(i, fun(data[i]));
-		if (rc != RC::SUCCESS) {
-			return rc;
+	// Coordinates are passed to fun in order, so blocks are not split between threads
+	return updateBlocks([&](double* block, size_t, size_t len) {
+		for (size_t i = 0; i < len; i++) {
+			block[i] = fun(block[i]);
 		}
-	}
-	return RC::SUCCESS;
+	}, false);
 }
 
 RC Vector::foreach (const std::function<void(double)>& fun) const {
+	count_operation(FOREACH, m_dim);
+
 	const double* data = getData();
 	for (size_t i = 0; i < m_dim; i++) {
 		fun(data[i]);
@@ -225,41 +557,114 @@ RC Vector::foreach (const std::function<void(double)>& fun) const {
 	return RC::SUCCESS;
 }
 
-size_t Vector::sizeAllocated() const { return sizeof(Vector) + m_dim * sizeof(double); }
+RC Vector::applyBlockFunction(const BlockFunction& fun) {
+	count_operation(APPLY, m_dim);
+
+	return updateBlocks([&](double* block, size_t, size_t len) { fun(block, block, len); }, false);
+}
+
+RC Vector::foreachBlock(const ConstBlockFunction& fun) const {
+	count_operation(FOREACH, m_dim);
+
+	const double* data = getData();
+
+	for (size_t begin = 0; begin < m_dim; begin += BLOCK_SIZE) {
+		fun(data + begin, std::min(BLOCK_SIZE, m_dim - begin));
+	}
+	return RC::SUCCESS;
+}
+
+size_t Vector::sizeAllocated() const {
+	switch (m_storage) {
+	case STORAGE::INLINE:
+		return PAYLOAD_OFFSET + m_dim * sizeof(double);
+
+	case STORAGE::SEPARATE:
+		return sizeof(Vector) + m_dim * sizeof(double);
+
+	default:
+		return sizeof(Vector);
+	}
+}
+
+Vector::Vector(size_t dim) {
+	m_dim = dim;
+	m_storage = STORAGE::INLINE;
+
+	auto* memBegin = reinterpret_cast<int8_t*>(this);
+	m_data = reinterpret_cast<double*>(memBegin + PAYLOAD_OFFSET);
+}
+
+Vector::Vector(size_t dim, double* data) : Vector(dim, data, STORAGE::VIEW) {}
 
-Vector::Vector(size_t dim) { m_dim = dim; }
+Vector::Vector(size_t dim, double* data, STORAGE storage) : m_dim(dim), m_data(data), m_storage(storage) {}
 
 IVector* IVector::createVector(size_t dim, double const* const& ptr_data) {
 	return Vector::createVector(dim, ptr_data);
 }
 
+IVector* IVector::createView(size_t dim, double* const& ptr_data) {
+	return Vector::createView(dim, ptr_data);
+}
+
 RC IVector::copyInstance(IVector* const dest, IVector const* const& src) {
 	if (!dest || !src) {
 		log_severe(RC::NULLPTR_ERROR);
 		return RC::NULLPTR_ERROR;
 	}
 
+	count_operation(COPY, src->getDim());
+
 	if (dest->getDim() != src->getDim()) {
 		return RC::MISMATCHING_DIMENSIONS;
 	}
 
-	auto srcMemBegin = reinterpret_cast<const uint8_t*>(src);
-	auto srcMemEnd = srcMemBegin + src->sizeAllocated();
-	auto destMemBegin = reinterpret_cast<uint8_t*>(dest);
-	auto destMemEnd = destMemBegin + dest->sizeAllocated();
+	size_t dim = src->getDim();
+
+	// Float storage can't overlap another vector, float source has no double coordinates and is read by dest
+	if (dest != src && src->getFloatData()) {
+		const double coeff = 1.0;
+		return dest->linearCombination(1, &coeff, &src);
+	}
+	if (dest != src && dest->getFloatData()) {
+		return dest->setData(dim, src->getData());
+	}
+
+	auto srcMemBegin = src->getData();
+	auto srcMemEnd = srcMemBegin + dim;
+	auto destMemBegin = dest->getData();
+	auto destMemEnd = destMemBegin + dim;
 
-	if (dest >= src && destMemBegin <= srcMemEnd || src >= dest && srcMemBegin <= destMemEnd) {
+	if ((destMemBegin < srcMemEnd && srcMemBegin < destMemEnd) || dest == src) {
 		return RC::MEMORY_INTERSECTION;
 	}
 
-	memcpy(dest, src, src->sizeAllocated());
-	return RC::SUCCESS;
+	// Only coordinates are copied, object headers may differ in padding and layout
+	return dest->setData(dim, srcMemBegin);
 }
 
 RC IVector::moveInstance(IVector* const dest, IVector*& src) {
-	RC rc = copyInstance(dest, src);
-	if (rc != RC::SUCCESS) {
-		return rc;
+	if (!dest || !src) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	count_operation(MOVE, src->getDim());
+
+	if (dest->getDim() != src->getDim()) {
+		return RC::MISMATCHING_DIMENSIONS;
+	}
+
+	if (dest == src) {
+		return RC::MEMORY_INTERSECTION;
+	}
+
+	// Separate storages never overlap, so only the copying fallback has to check memory
+	if (!dest->swapStorage(src)) {
+		RC rc = copyInstance(dest, src);
+		if (rc != RC::SUCCESS) {
+			return rc;
+		}
 	}
 
 	delete src;
@@ -268,32 +673,191 @@ RC IVector::moveInstance(IVector* const dest, IVector*& src) {
 }
 
 IVector* IVector::add(IVector const* const& op1, IVector const* const& op2) {
+	count_operation(ADD, op1 ? op1->getDim() : 0);
 	return VectorUtils::binaryOp(op1, op2, [](double x, double y) { return x + y; });
 }
 
 IVector* IVector::sub(IVector const* const& op1, IVector const* const& op2) {
+	count_operation(SUB, op1 ? op1->getDim() : 0);
 	return VectorUtils::binaryOp(op1, op2, [](double x, double y) { return x - y; });
 }
 
+RC IVector::add(IVector const* const& op1, IVector const* const& op2, IVector* const& dest) {
+	if (!op1 || !op2 || !dest) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	count_operation(ADD, dest->getDim());
+
+	const IVector* ops[] = { op1, op2 };
+	const double coeffs[] = { 1.0, 1.0 };
+	return dest->linearCombination(2, coeffs, ops);
+}
+
+RC IVector::sub(IVector const* const& op1, IVector const* const& op2, IVector* const& dest) {
+	if (!op1 || !op2 || !dest) {
+		log_severe(RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	count_operation(SUB, dest->getDim());
+
+	const IVector* ops[] = { op1, op2 };
+	const double coeffs[] = { 1.0, -1.0 };
+	return dest->linearCombination(2, coeffs, ops);
+}
+
+namespace {
+
+	using DenseSpan::DenseData;
+
+	double denseDot(const double* data1, const double* data2, size_t dim) {
+		return VectorParallel::reduceSum(dim, [&](size_t begin, size_t len) {
+			return VectorSummation::dot(data1 + begin, data2 + begin, len);
+		});
+	}
+
+	/*
+	 * Float operands are converted by summation blocks, so products are still added in active mode
+	 */
+	double denseDot(const DenseData& a, const DenseData& b, size_t dim) {
+		if (a.doubles && b.doubles) {
+			return denseDot(a.doubles, b.doubles, dim);
+		}
+
+		return VectorParallel::reduceSum(dim, [&](size_t begin, size_t len) {
+			return VectorSummation::sum(len, [&](size_t blockBegin, size_t blockLen) {
+				double blockA[VectorSummation::BLOCK_SIZE];
+				double blockB[VectorSummation::BLOCK_SIZE];
+				return VectorSummation::dot(DenseSpan::read(a, begin + blockBegin, blockLen, blockA),
+											DenseSpan::read(b, begin + blockBegin, blockLen, blockB), blockLen);
+			}, [&](size_t i) { return DenseSpan::at(a, begin + i) * DenseSpan::at(b, begin + i); });
+		});
+	}
+
+	double denseDistance(const double* data1, const double* data2, size_t dim, IVector::NORM n, double limit) {
+		const VectorKernels::KernelTable& kernels = VectorKernels::active();
+
+		switch (n) {
+		case IVector::NORM::FIRST:
+			return kernels.diffAbsSum(data1, data2, dim, limit);
+
+		case IVector::NORM::SECOND:
+			return kernels.diffSquareSum(data1, data2, dim, limit);
+
+		default:
+			return kernels.diffAbsMax(data1, data2, dim, limit);
+		}
+	}
+
+	/*
+	 * Float operands are converted block by block, limit is checked between blocks as well
+	 */
+	double denseDistance(const DenseData& a, const DenseData& b, size_t dim, IVector::NORM n, double limit) {
+		if (a.doubles && b.doubles) {
+			return denseDistance(a.doubles, b.doubles, dim, n, limit);
+		}
+
+		double blockA[DenseSpan::BLOCK_SIZE];
+		double blockB[DenseSpan::BLOCK_SIZE];
+		double res = 0;
+
+		for (size_t begin = 0; begin < dim && res < limit; begin += DenseSpan::BLOCK_SIZE) {
+			size_t len = std::min(DenseSpan::BLOCK_SIZE, dim - begin);
+			const double* data1 = DenseSpan::read(a, begin, len, blockA);
+			const double* data2 = DenseSpan::read(b, begin, len, blockB);
+
+			if (n == IVector::NORM::CHEBYSHEV) {
+				double part = denseDistance(data1, data2, len, n, limit);
+				if (!(part <= res)) {
+					res = part;
+				}
+			} else {
+				res += denseDistance(data1, data2, len, n, limit - res);
+			}
+		}
+		return res;
+	}
+
+	/*
+	 * Distance as in VectorKernels diff kernels, for any mix of sparse and dense operands
+	 */
+	double distance(IVector const* op1, IVector const* op2, IVector::NORM n, double limit) {
+		SparseKernels::SparseData sparse1;
+		SparseKernels::SparseData sparse2;
+		bool isSparse1 = SparseKernels::getSparse(op1, sparse1);
+		bool isSparse2 = SparseKernels::getSparse(op2, sparse2);
+
+		if (isSparse1 && isSparse2) {
+			return SparseKernels::distance(n, sparse1, sparse2, limit);
+		}
+
+		DenseData dense1;
+		DenseData dense2;
+		if ((!isSparse1 && !DenseSpan::getDense(op1, dense1)) ||
+			(!isSparse2 && !DenseSpan::getDense(op2, dense2))) {
+			return NAN;
+		}
+
+		size_t dim = op1->getDim();
+		if (isSparse1 || isSparse2) {
+			return isSparse1 ? SparseKernels::distance(n, sparse1, dense2, dim, limit)
+							 : SparseKernels::distance(n, sparse2, dense1, dim, limit);
+		}
+
+		return denseDistance(dense1, dense2, dim, n, limit);
+	}
+
+	/*
+	 * Euclidean distance compared in units of tol, for tol whose square underflows
+	 */
+	bool isScaledDistanceBelow(const DenseData& a, const DenseData& b, size_t dim, double tol) {
+		double res = 0;
+		for (size_t i = 0; i < dim && res < 1; i++) {
+			double diff = (DenseSpan::at(a, i) - DenseSpan::at(b, i)) / tol;
+			res += diff * diff;
+		}
+		return res < 1;
+	}
+
+} // namespace
+
 double IVector::dot(IVector const* const& op1, IVector const* const& op2) {
 	if (!op1 || !op2) {
 		log_severe(RC::NULLPTR_ERROR);
 		return false;
 	}
 
+	count_operation(DOT, op1->getDim());
+
 	if (op1->getDim() != op2->getDim()) {
 		log_warning(RC::MISMATCHING_DIMENSIONS);
 		return NAN;
 	}
 
-	size_t dim = op1->getDim();
-	double res = 0;
+	SparseKernels::SparseData sparse1;
+	SparseKernels::SparseData sparse2;
+	bool isSparse1 = SparseKernels::getSparse(op1, sparse1);
+	bool isSparse2 = SparseKernels::getSparse(op2, sparse2);
 
-	const double* data1 = op1->getData();
-	const double* data2 = op2->getData();
+	DenseData dense1;
+	DenseData dense2;
+	if ((!isSparse1 && !DenseSpan::getDense(op1, dense1)) ||
+		(!isSparse2 && !DenseSpan::getDense(op2, dense2))) {
+		log_warning(RC::ALLOCATION_ERROR);
+		return NAN;
+	}
 
-	for (size_t i = 0; i < dim; i++) {
-		res += data1[i] * data2[i];
+	double res = 0;
+	if (isSparse1 && isSparse2) {
+		res = SparseKernels::dot(sparse1, sparse2);
+	} else if (isSparse1) {
+		res = SparseKernels::dot(sparse1, dense2);
+	} else if (isSparse2) {
+		res = SparseKernels::dot(sparse2, dense1);
+	} else {
+		res = denseDot(dense1, dense2, op1->getDim());
 	}
 
 	if (isinf(res)) {
@@ -305,19 +869,76 @@ double IVector::dot(IVector const* const& op1, IVector const* const& op2) {
 }
 
 bool IVector::equals(IVector const* const& op1, IVector const* const& op2, NORM n, double tol) {
-	IVector* diff = sub(op1, op2);
-	if (!diff) {
+	if (!op1 || !op2) {
+		log_severe(RC::NULLPTR_ERROR);
+		return false;
+	}
+
+	count_operation(EQUALS, op1->getDim());
+
+	size_t dim = op1->getDim();
+	if (dim != op2->getDim()) {
+		log_warning(RC::MISMATCHING_DIMENSIONS);
+		return false;
+	}
+
+	// Distance never reaches a non-positive or NaN tolerance
+	if (!(tol > 0)) {
 		return false;
 	}
 
-	double diffNorm = diff->norm(n);
-	delete diff;
+	// Kernels stop as soon as partial distance reaches the tolerance
+	switch (n) {
+	case NORM::FIRST:
+	case NORM::CHEBYSHEV:
+		return distance(op1, op2, n, tol) < tol;
+
+	case NORM::SECOND: {
+		double squareTol = tol * tol;
+		if (squareTol < DBL_MIN) {
+			DenseData dense1;
+			DenseData dense2;
+			return DenseSpan::getDense(op1, dense1) && DenseSpan::getDense(op2, dense2) &&
+				   isScaledDistanceBelow(dense1, dense2, dim, tol);
+		}
+		return distance(op1, op2, n, squareTol) < squareTol;
+	}
 
-	if (isnan(diffNorm)) {
+	default:
+		log_severe(RC::UNKNOWN);
 		return false;
 	}
+}
 
-	return diffNorm < tol;
+bool IVector::equals(double const* data1, double const* data2, size_t dim, NORM n, double tol) {
+	if (!data1 || !data2) {
+		log_severe(RC::NULLPTR_ERROR);
+		return false;
+	}
+
+	count_operation(EQUALS, dim);
+
+	if (!(tol > 0)) {
+		return false;
+	}
+
+	switch (n) {
+	case NORM::FIRST:
+	case NORM::CHEBYSHEV:
+		return denseDistance(data1, data2, dim, n, tol) < tol;
+
+	case NORM::SECOND: {
+		double squareTol = tol * tol;
+		if (squareTol < DBL_MIN) {
+			return isScaledDistanceBelow({ data1, nullptr }, { data2, nullptr }, dim, tol);
+		}
+		return denseDistance(data1, data2, dim, n, squareTol) < squareTol;
+	}
+
+	default:
+		log_severe(RC::UNKNOWN);
+		return false;
+	}
 }
 
 IVector::~IVector() = default;
@@ -2,6 +2,7 @@
 #include <IVector.h>
 
 #include "LogUtils.h"
+#include "SparseKernels.h"
 
 using LogUtils::LogContainer;
 
@@ -13,6 +14,13 @@ namespace {
 		double const* getData() const override;
 		RC setData(size_t dim, double const* const& data) override;
 
+		PRECISION getPrecision() const override;
+		float const* getFloatData() const override;
+
+		size_t getNonZeroCount() const override;
+		size_t const* getNonZeroIndices() const override;
+		double const* getNonZeroValues() const override;
+
 		RC getCoord(size_t index, double& val) const override;
 		RC setCoord(size_t index, double val) override;
 		RC scale(double multiplier) override;
@@ -21,25 +29,82 @@ namespace {
 		RC inc(IVector const* const& op) override;
 		RC dec(IVector const* const& op) override;
 
+		RC axpy(double alpha, IVector const* const& op) override;
+		RC axpby(double alpha, IVector const* const& op, double beta) override;
+		RC linearCombination(size_t count, double const* coeffs, IVector const* const* ops) override;
+
 		double norm(NORM n) const override;
 
 		RC applyFunction(const std::function<double(double)>& fun) override;
 		RC foreach (const std::function<void(double)>& fun) const override;
 
+		/*
+		 * Spans are BLOCK_SIZE coordinates long, each one is validated right after fun while still in cache
+		 */
+		RC applyBlockFunction(const BlockFunction& fun) override;
+		RC foreachBlock(const ConstBlockFunction& fun) const override;
+
 		size_t sizeAllocated() const override;
 
 		static Vector* createVector(size_t dim, const double* const& data);
+		static Vector* createView(size_t dim, double* data);
 
-	private:
+		static void operator delete(void* ptr);
+
+		~Vector() override;
+
+		/*
+		 * View that can live on stack, used for scratch results inside the library
+		 */
+		Vector(size_t dim, double* data);
+
+	protected:
 		explicit Vector(size_t dim);
 
 		double* getData();
 
+		/*
+		 * Single finiteness scan over the whole array, logs once for the first bad coordinate
+		 */
+		static RC validateData(const double* data, size_t dim);
+
+		static const size_t BLOCK_SIZE = 1024;
+
+		// Distance from the object to its 64 byte aligned coordinates
+		static const size_t PAYLOAD_OFFSET;
+
+		bool swapStorage(IVector* other) override;
+
+	private:
+		enum class STORAGE {
+			INLINE,   // Right after the object
+			SEPARATE, // Own block, large vectors exchange it on move
+			VIEW      // External memory
+		};
+
+		Vector(size_t dim, double* data, STORAGE storage);
+
 		double infiniteNorm() const;
 		double firstNorm() const;
 		double secondNorm() const;
 
+		/*
+		 * Runs update(block, begin, len) on a stack copy of every BLOCK_SIZE span and stores the span only
+		 * if it stays finite, so a failed operation never leaves NaN or infinity behind. Spans before the
+		 * failed one, and in parallel also ones of other chunks, keep their new values
+		 */
+		template<class Update>
+		RC updateBlocks(const Update& update, bool isParallel);
+
+		/*
+		 * this += alpha * op touching only nonzero coordinates of op
+		 */
+		RC axpySparse(double alpha, const SparseKernels::SparseData& op);
+
 		size_t m_dim;
+
+		double* m_data;
+		STORAGE m_storage;
 	};
 
 } // namespace
@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+	#include <malloc.h>
+#endif
+
+#include "VectorAllocator.h"
+#include "VectorCounters.h"
+
+using VectorAllocator::ALIGNMENT;
+using VectorAllocator::HEADER_SIZE;
+
+namespace {
+
+	// 64 byte steps up to 1 KB, then powers of two up to 2 MB
+	const size_t SMALL_STEP = 64;
+	const size_t SMALL_LIMIT = 1024;
+	const size_t SMALL_CLASSES_NUMBER = SMALL_LIMIT / SMALL_STEP;
+	const size_t CLASSES_NUMBER = SMALL_CLASSES_NUMBER + 11;
+	const size_t LARGE_CLASS = CLASSES_NUMBER;
+
+	// Thread cache keeps roughly this many bytes of every class before spilling to shared pool
+	const size_t THREAD_CLASS_BYTES = 256 * 1024;
+
+	const size_t DEFAULT_RETENTION_LIMIT = 64 * 1024 * 1024;
+
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	void* alignedAlloc(size_t size) {
+#ifdef _WIN32
+		return _aligned_malloc(size, ALIGNMENT);
+#else
+		void* ptr = nullptr;
+		return posix_memalign(&ptr, ALIGNMENT, size) == 0 ? ptr : nullptr;
+#endif
+	}
+
+	void alignedFree(void* ptr) {
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		free(ptr);
+#endif
+	}
+
+	size_t classSize(size_t cls) {
+		if (cls < SMALL_CLASSES_NUMBER) {
+			return (cls + 1) * SMALL_STEP;
+		}
+		return SMALL_LIMIT << (cls - SMALL_CLASSES_NUMBER + 1);
+	}
+
+	size_t sizeClass(size_t size) {
+		if (size <= SMALL_LIMIT) {
+			return (size + SMALL_STEP - 1) / SMALL_STEP - 1;
+		}
+
+		size_t cls = SMALL_CLASSES_NUMBER;
+		while (cls < CLASSES_NUMBER && classSize(cls) < size) {
+			cls++;
+		}
+		return cls;
+	}
+
+	size_t threadCacheCapacity(size_t cls) { return std::max(size_t(2), THREAD_CLASS_BYTES / classSize(cls)); }
+
+	std::atomic<size_t> s_hits(0);
+	std::atomic<size_t> s_misses(0);
+	std::atomic<size_t> s_bytesRetained(0);
+	std::atomic<size_t> s_retentionLimit(DEFAULT_RETENTION_LIMIT);
+
+	void releaseList(FreeBlock*& list, size_t cls) {
+		while (list) {
+			FreeBlock* next = list->next;
+			alignedFree(list);
+			s_bytesRetained.fetch_sub(classSize(cls), std::memory_order_relaxed);
+			list = next;
+		}
+	}
+
+	struct SharedPool {
+		std::mutex mutex;
+		FreeBlock* lists[CLASSES_NUMBER] = {};
+		size_t bytes = 0;
+
+		FreeBlock* pop(size_t cls) {
+			std::lock_guard<std::mutex> lock(mutex);
+
+			FreeBlock* block = lists[cls];
+			if (block) {
+				lists[cls] = block->next;
+				bytes -= classSize(cls);
+			}
+			return block;
+		}
+
+		bool push(FreeBlock* block, size_t cls) {
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (bytes + classSize(cls) > s_retentionLimit.load(std::memory_order_relaxed)) {
+				return false;
+			}
+
+			block->next = lists[cls];
+			lists[cls] = block;
+			bytes += classSize(cls);
+			return true;
+		}
+
+		void trim() {
+			std::lock_guard<std::mutex> lock(mutex);
+
+			for (size_t cls = 0; cls < CLASSES_NUMBER; cls++) {
+				releaseList(lists[cls], cls);
+			}
+			bytes = 0;
+		}
+	};
+
+	// Never destroyed, blocks may be returned by thread caches during process shutdown
+	SharedPool& sharedPool() {
+		static SharedPool* pool = new SharedPool();
+		return *pool;
+	}
+
+	struct ThreadCache;
+
+	// Every alive thread cache, so that trim can ask other threads to drain theirs
+	struct CacheRegistry {
+		std::mutex mutex;
+		std::vector<ThreadCache*> caches;
+	};
+
+	// Never destroyed for the same reason as the shared pool
+	CacheRegistry& cacheRegistry() {
+		static CacheRegistry* registry = new CacheRegistry();
+		return *registry;
+	}
+
+	enum class CacheState : uint8_t {
+		NOT_CREATED,
+		ALIVE,
+		DESTROYED
+	};
+
+	thread_local CacheState t_cacheState = CacheState::NOT_CREATED;
+
+	/*
+	 * Lists are touched only by the owning thread, so pop and push take no lock. Trim of another thread
+	 * only sets isDrainRequested, the owner releases its blocks on the next pop or push
+	 */
+	struct ThreadCache {
+		FreeBlock* lists[CLASSES_NUMBER] = {};
+		size_t counts[CLASSES_NUMBER] = {};
+		size_t bytes = 0;
+		std::atomic<bool> isDrainRequested{ false };
+
+		ThreadCache() {
+			t_cacheState = CacheState::ALIVE;
+
+			CacheRegistry& registry = cacheRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.caches.push_back(this);
+		}
+
+		~ThreadCache() {
+			t_cacheState = CacheState::DESTROYED;
+
+			// Flag must not be set after the cache is gone
+			{
+				CacheRegistry& registry = cacheRegistry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				registry.caches.erase(std::find(registry.caches.begin(), registry.caches.end(), this));
+			}
+
+			for (size_t cls = 0; cls < CLASSES_NUMBER; cls++) {
+				while (lists[cls]) {
+					FreeBlock* block = lists[cls];
+					lists[cls] = block->next;
+
+					if (!sharedPool().push(block, cls)) {
+						alignedFree(block);
+						s_bytesRetained.fetch_sub(classSize(cls), std::memory_order_relaxed);
+					}
+				}
+			}
+		}
+
+		// Called by the owning thread only
+		void trim() {
+			for (size_t cls = 0; cls < CLASSES_NUMBER; cls++) {
+				releaseList(lists[cls], cls);
+				counts[cls] = 0;
+			}
+			bytes = 0;
+		}
+
+		void drainIfRequested() {
+			if (isDrainRequested.load(std::memory_order_relaxed) &&
+				isDrainRequested.exchange(false, std::memory_order_relaxed)) {
+				trim();
+			}
+		}
+
+		FreeBlock* pop(size_t cls) {
+			drainIfRequested();
+
+			FreeBlock* block = lists[cls];
+			if (block) {
+				lists[cls] = block->next;
+				counts[cls]--;
+				bytes -= classSize(cls);
+			}
+			return block;
+		}
+
+		// Retention limit caps every cache as well as the shared pool
+		bool push(FreeBlock* block, size_t cls) {
+			drainIfRequested();
+
+			if (counts[cls] >= threadCacheCapacity(cls) ||
+				bytes + classSize(cls) > s_retentionLimit.load(std::memory_order_relaxed)) {
+				return false;
+			}
+
+			block->next = lists[cls];
+			lists[cls] = block;
+			counts[cls]++;
+			bytes += classSize(cls);
+			return true;
+		}
+	};
+
+	ThreadCache* threadCache() {
+		if (t_cacheState == CacheState::DESTROYED) {
+			return nullptr;
+		}
+
+		thread_local ThreadCache cache;
+		return &cache;
+	}
+
+	void* withHeader(void* raw, size_t cls) {
+		*static_cast<size_t*>(raw) = cls;
+		return static_cast<uint8_t*>(raw) + HEADER_SIZE;
+	}
+
+} // namespace
+
+void* VectorAllocator::allocate(size_t size) {
+	count_allocation(size);
+
+	size_t cls = sizeClass(size + HEADER_SIZE);
+
+	if (cls == LARGE_CLASS) {
+		void* raw = alignedAlloc(size + HEADER_SIZE);
+		if (!raw) {
+			return nullptr;
+		}
+
+		s_misses.fetch_add(1, std::memory_order_relaxed);
+		return withHeader(raw, cls);
+	}
+
+	ThreadCache* cache = threadCache();
+	FreeBlock* block = cache ? cache->pop(cls) : nullptr;
+	if (!block) {
+		block = sharedPool().pop(cls);
+	}
+
+	if (block) {
+		s_hits.fetch_add(1, std::memory_order_relaxed);
+		s_bytesRetained.fetch_sub(classSize(cls), std::memory_order_relaxed);
+		return withHeader(block, cls);
+	}
+
+	void* raw = alignedAlloc(classSize(cls));
+	if (!raw) {
+		return nullptr;
+	}
+
+	s_misses.fetch_add(1, std::memory_order_relaxed);
+	return withHeader(raw, cls);
+}
+
+void VectorAllocator::deallocate(void* ptr) {
+	if (!ptr) {
+		return;
+	}
+
+	void* raw = static_cast<uint8_t*>(ptr) - HEADER_SIZE;
+	size_t cls = *static_cast<size_t*>(raw);
+
+	if (cls == LARGE_CLASS || s_retentionLimit.load(std::memory_order_relaxed) == 0) {
+		alignedFree(raw);
+		return;
+	}
+
+	auto block = static_cast<FreeBlock*>(raw);
+	s_bytesRetained.fetch_add(classSize(cls), std::memory_order_relaxed);
+
+	ThreadCache* cache = threadCache();
+	if (cache && cache->push(block, cls)) {
+		return;
+	}
+
+	if (!sharedPool().push(block, cls)) {
+		s_bytesRetained.fetch_sub(classSize(cls), std::memory_order_relaxed);
+		alignedFree(raw);
+	}
+}
+
+// Payload starts on the cache line following the header
+void* VectorAllocator::allocatePayload(size_t size) {
+	auto mem = static_cast<uint8_t*>(allocate(size + ALIGNMENT - HEADER_SIZE));
+	return mem ? mem + ALIGNMENT - HEADER_SIZE : nullptr;
+}
+
+void VectorAllocator::deallocatePayload(void* ptr) {
+	if (ptr) {
+		deallocate(static_cast<uint8_t*>(ptr) - (ALIGNMENT - HEADER_SIZE));
+	}
+}
+
+IVector::PoolStatistics VectorAllocator::getStatistics() {
+	IVector::PoolStatistics stats;
+	stats.hits = s_hits.load(std::memory_order_relaxed);
+	stats.misses = s_misses.load(std::memory_order_relaxed);
+	stats.bytesRetained = s_bytesRetained.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void VectorAllocator::trim() {
+	ThreadCache* own = threadCache();
+	{
+		CacheRegistry& registry = cacheRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (ThreadCache* cache : registry.caches) {
+			if (cache != own) {
+				cache->isDrainRequested.store(true, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	if (own) {
+		own->trim();
+	}
+	sharedPool().trim();
+}
+
+void VectorAllocator::setRetentionLimit(size_t bytes) {
+	s_retentionLimit.store(bytes, std::memory_order_relaxed);
+	if (bytes == 0) {
+		trim();
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+#include <IVector.h>
+
+/*
+ * Size-class allocator for vector instances
+ *
+ * Freed blocks are kept in per-thread free lists, overflowing lists spill into a shared pool
+ * guarded by mutex. Thread caches take no lock. Blocks bigger than the largest size class bypass the pool
+ */
+namespace VectorAllocator {
+
+	// Every block starts on a cache line, pointer returned by allocate() is HEADER_SIZE bytes past it
+	const size_t ALIGNMENT = 64;
+	const size_t HEADER_SIZE = 16;
+
+	void* allocate(size_t size);
+	void deallocate(void* ptr);
+
+	// Coordinates taking at least this many bytes live in a block of their own instead of after the object
+	const size_t SEPARATE_PAYLOAD_SIZE = 64 * 1024;
+
+	/*
+	 * Cache line aligned block for coordinates stored apart from vector object
+	 */
+	void* allocatePayload(size_t size);
+	void deallocatePayload(void* ptr);
+
+	IVector::PoolStatistics getStatistics();
+
+	/*
+	 * Releases blocks cached by the calling thread and by the shared pool. Other threads release
+	 * their caches on their next allocation or deallocation, or when they exit
+	 */
+	void trim();
+
+	void setRetentionLimit(size_t bytes);
+
+} // namespace VectorAllocator
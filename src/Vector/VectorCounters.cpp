@@ -0,0 +1,69 @@
+#include "LogUtils.h"
+#include "VectorCounters.h"
+
+namespace {
+
+	const size_t OPERATIONS_NUMBER = static_cast<size_t>(IVector::OPERATION::AMOUNT);
+
+	// Relaxed increments only, a snapshot taken while other threads count may be slightly torn
+	std::atomic<size_t> s_calls[OPERATIONS_NUMBER];
+	std::atomic<size_t> s_coordinates[OPERATIONS_NUMBER];
+	std::atomic<size_t> s_allocations(0);
+	std::atomic<size_t> s_bytesAllocated(0);
+
+} // namespace
+
+std::atomic<bool> VectorCounters::s_isEnabled(false);
+
+void VectorCounters::addCall(IVector::OPERATION op, size_t coordinates) {
+	auto index = static_cast<size_t>(op);
+	s_calls[index].fetch_add(1, std::memory_order_relaxed);
+	s_coordinates[index].fetch_add(coordinates, std::memory_order_relaxed);
+}
+
+void VectorCounters::addAllocation(size_t bytes) {
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	s_bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+IVector::OperationCounters VectorCounters::get() {
+	IVector::OperationCounters counters;
+	for (size_t i = 0; i < OPERATIONS_NUMBER; i++) {
+		counters.calls[i] = s_calls[i].load(std::memory_order_relaxed);
+		counters.coordinates[i] = s_coordinates[i].load(std::memory_order_relaxed);
+	}
+	counters.allocations = s_allocations.load(std::memory_order_relaxed);
+	counters.bytesAllocated = s_bytesAllocated.load(std::memory_order_relaxed);
+	return counters;
+}
+
+void VectorCounters::reset() {
+	for (size_t i = 0; i < OPERATIONS_NUMBER; i++) {
+		s_calls[i].store(0, std::memory_order_relaxed);
+		s_coordinates[i].store(0, std::memory_order_relaxed);
+	}
+	s_allocations.store(0, std::memory_order_relaxed);
+	s_bytesAllocated.store(0, std::memory_order_relaxed);
+}
+
+RC IVector::setCountersEnabled(bool enabled) {
+#ifdef VECTOR_COUNTERS
+	VectorCounters::s_isEnabled.store(enabled, std::memory_order_relaxed);
+	return RC::SUCCESS;
+#else
+	if (enabled) {
+		log_warning_in(getLogger(), RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+	return RC::SUCCESS;
+#endif
+}
+
+bool IVector::isCountersEnabled() { return VectorCounters::isEnabled(); }
+
+IVector::OperationCounters IVector::getOperationCounters() { return VectorCounters::get(); }
+
+RC IVector::resetOperationCounters() {
+	VectorCounters::reset();
+	return RC::SUCCESS;
+}
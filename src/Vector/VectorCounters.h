@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include <IVector.h>
+
+/*
+ * Counters behind IVector::getOperationCounters
+ *
+ * Library code counts through count_operation and count_allocation macros, which expand to nothing
+ * unless VECTOR_COUNTERS is defined
+ */
+namespace VectorCounters {
+
+	extern std::atomic<bool> s_isEnabled;
+
+	inline bool isEnabled() { return s_isEnabled.load(std::memory_order_relaxed); }
+
+	void addCall(IVector::OPERATION op, size_t coordinates);
+	void addAllocation(size_t bytes);
+
+	IVector::OperationCounters get();
+	void reset();
+
+} // namespace VectorCounters
+
+#ifdef VECTOR_COUNTERS
+	#define count_operation(op, coordinates)                                                               \
+		do {                                                                                               \
+			if (VectorCounters::isEnabled()) {                                                             \
+				VectorCounters::addCall(IVector::OPERATION::op, coordinates);                              \
+			}                                                                                              \
+		} while (false)
+
+	#define count_allocation(bytes)                                                                        \
+		do {                                                                                               \
+			if (VectorCounters::isEnabled()) {                                                             \
+				VectorCounters::addAllocation(bytes);                                                      \
+			}                                                                                              \
+		} while (false)
+#else
+	#define count_operation(op, coordinates) ((void)0)
+	#define count_allocation(bytes) ((void)0)
+#endif
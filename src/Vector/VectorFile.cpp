@@ -0,0 +1,381 @@
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "DenseSpan.h"
+#include "LogUtils.h"
+#include "VectorFile.h"
+
+namespace {
+
+	const char MAGIC[8] = { 'I', 'V', 'E', 'C', 'T', 'O', 'R', 'S' };
+	const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+	// Same as the alignment of coordinates allocated by the library
+	const uint64_t ALIGNMENT = 64;
+
+	static_assert(sizeof(FileHeader) == ALIGNMENT, "Header must keep the first record aligned");
+
+	FileHeader makeHeader(uint64_t count) {
+		FileHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = IVectorFile::VERSION;
+		header.byteOrder = BYTE_ORDER_MARK;
+		header.count = count;
+		return header;
+	}
+
+	bool isValidHeader(const FileHeader& header) {
+		return memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == IVectorFile::VERSION &&
+			   header.byteOrder == BYTE_ORDER_MARK;
+	}
+
+	// First record position at or after offset with coordinates on ALIGNMENT boundary
+	uint64_t recordOffset(uint64_t offset) {
+		return (offset + sizeof(uint64_t) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT - sizeof(uint64_t);
+	}
+
+	// Offset right after record of dim coordinates, 0 if it doesn't fit into size bytes
+	uint64_t recordEnd(uint64_t record, uint64_t dim, uint64_t size) {
+		uint64_t begin = record + sizeof(uint64_t);
+		if (begin > size || dim > (size - begin) / sizeof(double)) {
+			return 0;
+		}
+		return begin + dim * sizeof(double);
+	}
+
+	bool seek(FILE* file, uint64_t offset) {
+#ifdef _WIN32
+		return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+		return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+	}
+
+	bool fileSize(FILE* file, uint64_t& size) {
+#ifdef _WIN32
+		if (_fseeki64(file, 0, SEEK_END) != 0) {
+			return false;
+		}
+		__int64 end = _ftelli64(file);
+#else
+		if (fseeko(file, 0, SEEK_END) != 0) {
+			return false;
+		}
+		off_t end = ftello(file);
+#endif
+		size = static_cast<uint64_t>(end);
+		return end >= 0;
+	}
+
+	/*
+	 * Maps the whole file read only, nullptr with rc set on failure
+	 */
+	void* mapFile(const char* path, size_t& size, RC& rc) {
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+								  FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			rc = RC::FILE_NOT_FOUND;
+			return nullptr;
+		}
+
+		LARGE_INTEGER length;
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &length) && length.QuadPart >= static_cast<LONGLONG>(sizeof(FileHeader))) {
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		CloseHandle(file);
+
+		rc = RC::IO_ERROR;
+		if (!mapping) {
+			return nullptr;
+		}
+
+		// View keeps the mapping object alive by itself
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!view) {
+			return nullptr;
+		}
+
+		size = static_cast<size_t>(length.QuadPart);
+		rc = RC::SUCCESS;
+		return view;
+#else
+		int fd = open(path, O_RDONLY);
+		if (fd < 0) {
+			rc = RC::FILE_NOT_FOUND;
+			return nullptr;
+		}
+
+		struct stat info;
+		void* view = MAP_FAILED;
+		if (fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(FileHeader))) {
+			view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		close(fd);
+
+		if (view == MAP_FAILED) {
+			rc = RC::IO_ERROR;
+			return nullptr;
+		}
+
+		size = static_cast<size_t>(info.st_size);
+		rc = RC::SUCCESS;
+		return view;
+#endif
+	}
+
+	void unmapFile(void* mapping, size_t size) {
+#ifdef _WIN32
+		UnmapViewOfFile(mapping);
+#else
+		munmap(mapping, size);
+#endif
+	}
+
+} // namespace
+
+const unsigned IVectorFile::VERSION;
+
+IVectorFile* IVectorFile::load(char const* const& path) { return VectorFile::load(path); }
+
+RC IVectorFile::save(char const* const& path, size_t count, IVector const* const* vectors) {
+	if (!vectors && count != 0) {
+		log_severe_in(IVector::getLogger(), RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	IWriter* writer = createWriter(path, false);
+	if (!writer) {
+		return RC::IO_ERROR;
+	}
+
+	RC rc = RC::SUCCESS;
+	for (size_t i = 0; i < count && rc == RC::SUCCESS; i++) {
+		rc = writer->append(vectors[i]);
+	}
+	if (rc == RC::SUCCESS) {
+		rc = writer->flush();
+	}
+
+	delete writer;
+	return rc;
+}
+
+IVectorFile::IWriter* IVectorFile::createWriter(char const* const& path, bool append) {
+	return VectorFile::Writer::createWriter(path, append);
+}
+
+IVectorFile::~IVectorFile() = default;
+
+IVectorFile::IWriter::~IWriter() = default;
+
+VectorFile* VectorFile::load(const char* path) {
+	if (!path) {
+		log_severe_in(IVector::getLogger(), RC::NULLPTR_ERROR);
+		return nullptr;
+	}
+
+	auto file = new (std::nothrow) VectorFile();
+	if (!file) {
+		log_warning_in(IVector::getLogger(), RC::ALLOCATION_ERROR);
+		return nullptr;
+	}
+
+	RC rc = RC::SUCCESS;
+	file->m_mapping = mapFile(path, file->m_size, rc);
+	if (!file->m_mapping) {
+		log_warning_in(IVector::getLogger(), rc);
+		delete file;
+		return nullptr;
+	}
+
+	auto header = static_cast<const FileHeader*>(file->m_mapping);
+	if (!isValidHeader(*header) || !file->createViews(header->count)) {
+		log_warning_in(IVector::getLogger(), RC::IO_ERROR);
+		delete file;
+		return nullptr;
+	}
+
+	return file;
+}
+
+bool VectorFile::createViews(uint64_t count) {
+	auto begin = static_cast<const uint8_t*>(m_mapping);
+
+	uint64_t offset = sizeof(FileHeader);
+	for (uint64_t i = 0; i < count; i++) {
+		uint64_t record = recordOffset(offset);
+		if (recordEnd(record, 0, m_size) == 0) {
+			return false;
+		}
+
+		uint64_t dim;
+		memcpy(&dim, begin + record, sizeof(dim));
+		offset = recordEnd(record, dim, m_size);
+		if (offset == 0) {
+			return false;
+		}
+
+		// Mapping is read only, views are handed out as const only
+		auto data = reinterpret_cast<const double*>(begin + record + sizeof(uint64_t));
+		IVector* view = IVector::createView(static_cast<size_t>(dim), const_cast<double*>(data));
+		if (!view) {
+			return false;
+		}
+		m_vectors.push_back(view);
+	}
+	return true;
+}
+
+size_t VectorFile::getCount() const { return m_vectors.size(); }
+
+IVector const* VectorFile::getVector(size_t index) const {
+	if (index >= m_vectors.size()) {
+		log_warning_in(IVector::getLogger(), RC::INDEX_OUT_OF_BOUND);
+		return nullptr;
+	}
+	return m_vectors[index];
+}
+
+VectorFile::~VectorFile() {
+	for (auto vector : m_vectors) {
+		delete vector;
+	}
+	if (m_mapping) {
+		unmapFile(m_mapping, m_size);
+	}
+}
+
+VectorFile::Writer* VectorFile::Writer::createWriter(const char* path, bool append) {
+	if (!path) {
+		log_severe_in(IVector::getLogger(), RC::NULLPTR_ERROR);
+		return nullptr;
+	}
+
+	uint64_t count = 0;
+	uint64_t end = sizeof(FileHeader);
+
+	// Existing file is continued only if it is valid, otherwise it is left untouched
+	FILE* file = append ? fopen(path, "r+b") : nullptr;
+	if (file && !findEnd(file, count, end)) {
+		fclose(file);
+		log_warning_in(IVector::getLogger(), RC::IO_ERROR);
+		return nullptr;
+	}
+
+	if (!file) {
+		file = fopen(path, "w+b");
+
+		FileHeader header = makeHeader(0);
+		if (file && fwrite(&header, sizeof(header), 1, file) != 1) {
+			fclose(file);
+			file = nullptr;
+		}
+	}
+
+	if (!file) {
+		log_warning_in(IVector::getLogger(), RC::IO_ERROR);
+		return nullptr;
+	}
+
+	auto writer = new (std::nothrow) Writer(file, count, end);
+	if (!writer) {
+		log_warning_in(IVector::getLogger(), RC::ALLOCATION_ERROR);
+		fclose(file);
+	}
+	return writer;
+}
+
+bool VectorFile::Writer::findEnd(FILE* file, uint64_t& count, uint64_t& end) {
+	// Records past the count of a writer that wasn't flushed are overwritten
+	FileHeader header;
+	uint64_t size = 0;
+	bool isValid = fread(&header, sizeof(header), 1, file) == 1 && isValidHeader(header) && fileSize(file, size);
+
+	uint64_t offset = sizeof(FileHeader);
+	for (uint64_t i = 0; isValid && i < header.count; i++) {
+		uint64_t record = recordOffset(offset);
+		uint64_t dim = 0;
+
+		isValid = recordEnd(record, 0, size) != 0 && seek(file, record) && fread(&dim, sizeof(dim), 1, file) == 1;
+		offset = isValid ? recordEnd(record, dim, size) : 0;
+		isValid = offset != 0;
+	}
+
+	if (!isValid || !seek(file, offset)) {
+		return false;
+	}
+
+	count = header.count;
+	end = offset;
+	return true;
+}
+
+VectorFile::Writer::Writer(FILE* file, uint64_t count, uint64_t end) : m_file(file), m_count(count), m_end(end) {}
+
+RC VectorFile::Writer::append(IVector const* const& vector) {
+	if (!vector) {
+		log_severe_in(IVector::getLogger(), RC::NULLPTR_ERROR);
+		return RC::NULLPTR_ERROR;
+	}
+
+	DenseSpan::DenseData dense;
+	if (!DenseSpan::getDense(vector, dense)) {
+		return RC::ALLOCATION_ERROR;
+	}
+
+	static const uint8_t padding[ALIGNMENT] = {};
+
+	uint64_t dim = vector->getDim();
+	uint64_t record = recordOffset(m_end);
+	size_t paddingSize = static_cast<size_t>(record - m_end);
+
+	bool isWritten = fwrite(padding, 1, paddingSize, m_file) == paddingSize &&
+					 fwrite(&dim, sizeof(dim), 1, m_file) == 1;
+
+	// Float coordinates are written converted span by span
+	DenseSpan::forBlocks(dense, static_cast<size_t>(dim), [&](size_t, const double* data, size_t len) {
+		isWritten = isWritten && fwrite(data, sizeof(double), len, m_file) == len;
+	});
+	if (!isWritten) {
+		// Partial record is past the end known to header, so it is overwritten by the next append
+		seek(m_file, m_end);
+		log_warning_in(IVector::getLogger(), RC::IO_ERROR);
+		return RC::IO_ERROR;
+	}
+
+	m_end = record + sizeof(uint64_t) + dim * sizeof(double);
+	m_count++;
+	return RC::SUCCESS;
+}
+
+size_t VectorFile::Writer::getCount() const { return static_cast<size_t>(m_count); }
+
+RC VectorFile::Writer::flush() {
+	FileHeader header = makeHeader(m_count);
+
+	bool isWritten = seek(m_file, 0) && fwrite(&header, sizeof(header), 1, m_file) == 1 && seek(m_file, m_end) &&
+					 fflush(m_file) == 0;
+	if (!isWritten) {
+		log_warning_in(IVector::getLogger(), RC::IO_ERROR);
+		return RC::IO_ERROR;
+	}
+	return RC::SUCCESS;
+}
+
+VectorFile::Writer::~Writer() {
+	flush();
+	fclose(m_file);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <IVectorFile.h>
+
+namespace {
+
+	struct FileHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrder;
+		uint64_t count;
+		uint8_t reserved[40];
+	};
+
+	/*
+	 * Read only mapping of the whole file with a view created for every record
+	 */
+	class VectorFile : public IVectorFile {
+	public:
+		size_t getCount() const override;
+		IVector const* getVector(size_t index) const override;
+
+		static VectorFile* load(const char* path);
+
+		~VectorFile() override;
+
+		class Writer : public IVectorFile::IWriter {
+		public:
+			RC append(IVector const* const& vector) override;
+			size_t getCount() const override;
+			RC flush() override;
+
+			static Writer* createWriter(const char* path, bool append);
+
+			~Writer() override;
+
+		private:
+			Writer(FILE* file, uint64_t count, uint64_t end);
+
+			// Validates existing file and positions it right after its last record
+			static bool findEnd(FILE* file, uint64_t& count, uint64_t& end);
+
+			FILE* m_file;
+			uint64_t m_count;
+
+			// Offset right after the last record, the file is always positioned there between calls
+			uint64_t m_end;
+		};
+
+	private:
+		VectorFile() = default;
+
+		/*
+		 * Walks records of the mapping creating views, false if they don't fit into the file
+		 */
+		bool createViews(uint64_t count);
+
+		void* m_mapping = nullptr;
+		size_t m_size = 0;
+
+		std::vector<IVector*> m_vectors;
+	};
+
+} // namespace
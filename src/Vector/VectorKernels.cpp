@@ -0,0 +1,266 @@
+#include <atomic>
+#include <cmath>
+
+#include "VectorKernels.h"
+
+#if defined(VECTOR_KERNELS_X86) && defined(_MSC_VER)
+	#include <intrin.h>
+	#include <immintrin.h>
+#endif
+
+using VectorKernels::InstructionSet;
+using VectorKernels::KernelTable;
+
+namespace {
+
+	double scalarDot(const double* a, const double* b, size_t n) {
+		double res = 0;
+		for (size_t i = 0; i < n; i++) {
+			res += a[i] * b[i];
+		}
+		return res;
+	}
+
+	double scalarAbsSum(const double* a, size_t n) {
+		double res = 0;
+		for (size_t i = 0; i < n; i++) {
+			res += fabs(a[i]);
+		}
+		return res;
+	}
+
+	double scalarSquareSum(const double* a, size_t n) {
+		double res = 0;
+		for (size_t i = 0; i < n; i++) {
+			res += a[i] * a[i];
+		}
+		return res;
+	}
+
+	double scalarAbsMax(const double* a, size_t n) {
+		double res = 0;
+		for (size_t i = 0; i < n && !std::isnan(res); i++) {
+			// Unlike fmax keeps NaN, which also stops the loop
+			double x = fabs(a[i]);
+			if (!(x <= res)) {
+				res = x;
+			}
+		}
+		return res;
+	}
+
+	void scalarAdd(double* dst, const double* src, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			dst[i] += src[i];
+		}
+	}
+
+	void scalarSub(double* dst, const double* src, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			dst[i] -= src[i];
+		}
+	}
+
+	void scalarScale(double* a, double multiplier, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			a[i] *= multiplier;
+		}
+	}
+
+	void scalarAxpy(double* y, double alpha, const double* x, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			y[i] += alpha * x[i];
+		}
+	}
+
+	void scalarAxpby(double* y, double alpha, const double* x, double beta, size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			y[i] = alpha * x[i] + beta * y[i];
+		}
+	}
+
+	double scalarDiffAbsSum(const double* a, const double* b, size_t n, double limit) {
+		double res = 0;
+		for (size_t i = 0; i < n && res < limit; i++) {
+			res += fabs(a[i] - b[i]);
+		}
+		return res;
+	}
+
+	double scalarDiffSquareSum(const double* a, const double* b, size_t n, double limit) {
+		double res = 0;
+		for (size_t i = 0; i < n && res < limit; i++) {
+			double diff = a[i] - b[i];
+			res += diff * diff;
+		}
+		return res;
+	}
+
+	double scalarDiffAbsMax(const double* a, const double* b, size_t n, double limit) {
+		double res = 0;
+		for (size_t i = 0; i < n && res < limit; i++) {
+			// Unlike fmax keeps NaN, which also stops the loop
+			double diff = fabs(a[i] - b[i]);
+			if (!(diff <= res)) {
+				res = diff;
+			}
+		}
+		return res;
+	}
+
+	const KernelTable s_scalarKernels = {
+		scalarDot,
+		scalarAbsSum,
+		scalarSquareSum,
+		scalarAbsMax,
+		scalarAdd,
+		scalarSub,
+		scalarScale,
+		scalarAxpy,
+		scalarAxpby,
+		scalarDiffAbsSum,
+		scalarDiffSquareSum,
+		scalarDiffAbsMax,
+		VectorKernels::scalarFindNonFinite,
+	};
+
+#if defined(VECTOR_KERNELS_X86) && defined(_MSC_VER)
+	bool osSavesYmm(unsigned long long mask) {
+		int info[4];
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		return osxsave && (_xgetbv(0) & mask) == mask;
+	}
+#endif
+
+	bool cpuSupports(InstructionSet set) {
+		if (set == InstructionSet::SCALAR) {
+			return true;
+		}
+
+#if defined(VECTOR_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+		__builtin_cpu_init();
+
+		switch (set) {
+		case InstructionSet::SSE2:
+			return __builtin_cpu_supports("sse2");
+
+		case InstructionSet::AVX2:
+			return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+		case InstructionSet::AVX512:
+			return __builtin_cpu_supports("avx512f");
+
+		default:
+			return false;
+		}
+
+#elif defined(VECTOR_KERNELS_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool fma = (info[2] & (1 << 12)) != 0;
+
+		bool avx2 = false;
+		bool avx512f = false;
+		if (maxLeaf >= 7) {
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+			avx512f = (info[1] & (1 << 16)) != 0;
+		}
+
+		switch (set) {
+		case InstructionSet::SSE2:
+			return sse2;
+
+		case InstructionSet::AVX2:
+			return avx2 && fma && osSavesYmm(0x6);
+
+		case InstructionSet::AVX512:
+			return avx512f && osSavesYmm(0xE6);
+
+		default:
+			return false;
+		}
+
+#else
+		return false;
+#endif
+	}
+
+	const KernelTable* compiledKernels(InstructionSet set) {
+		switch (set) {
+		case InstructionSet::SCALAR:
+			return &s_scalarKernels;
+
+		case InstructionSet::SSE2:
+			return VectorKernels::sse2Kernels();
+
+		case InstructionSet::AVX2:
+			return VectorKernels::avx2Kernels();
+
+		case InstructionSet::AVX512:
+			return VectorKernels::avx512Kernels();
+
+		default:
+			return nullptr;
+		}
+	}
+
+	InstructionSet detectBestSet() {
+		const InstructionSet order[] = {
+			InstructionSet::AVX512,
+			InstructionSet::AVX2,
+			InstructionSet::SSE2,
+		};
+
+		for (auto set : order) {
+			if (VectorKernels::get(set)) {
+				return set;
+			}
+		}
+		return InstructionSet::SCALAR;
+	}
+
+	// Initialized during library loading, so the choice is made once per process
+	std::atomic<InstructionSet> s_activeSet(detectBestSet());
+	std::atomic<const KernelTable*> s_activeKernels(VectorKernels::get(s_activeSet));
+
+} // namespace
+
+size_t VectorKernels::scalarFindNonFinite(const double* a, size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		if (std::isnan(a[i]) || std::isinf(a[i])) {
+			return i;
+		}
+	}
+	return n;
+}
+
+const KernelTable& VectorKernels::scalarKernels() { return s_scalarKernels; }
+
+const KernelTable* VectorKernels::get(InstructionSet set) {
+	auto kernels = compiledKernels(set);
+	if (!kernels || !cpuSupports(set)) {
+		return nullptr;
+	}
+	return kernels;
+}
+
+const KernelTable& VectorKernels::active() { return *s_activeKernels.load(std::memory_order_relaxed); }
+
+bool VectorKernels::setActive(InstructionSet set) {
+	auto kernels = get(set);
+	if (!kernels) {
+		return false;
+	}
+
+	s_activeKernels.store(kernels);
+	s_activeSet.store(set);
+	return true;
+}
+
+InstructionSet VectorKernels::activeSet() { return s_activeSet.load(); }
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+
+#include <IVector.h>
+
+/*
+ * Low level loops over raw coordinate arrays
+ *
+ * Every instruction set provides its own table of kernels, the active one is chosen
+ * once at library load time by CPUID and can be overridden with IVector::setInstructionSet
+ */
+namespace VectorKernels {
+
+	struct KernelTable {
+		double (*dot)(const double* a, const double* b, size_t n);
+
+		double (*absSum)(const double* a, size_t n);
+		double (*squareSum)(const double* a, size_t n);
+		double (*absMax)(const double* a, size_t n);
+
+		// dst[i] += src[i] and dst[i] -= src[i]
+		void (*add)(double* dst, const double* src, size_t n);
+		void (*sub)(double* dst, const double* src, size_t n);
+
+		// a[i] *= multiplier
+		void (*scale)(double* a, double multiplier, size_t n);
+
+		// y[i] += alpha * x[i] and y[i] = alpha * x[i] + beta * y[i]
+		void (*axpy)(double* y, double alpha, const double* x, size_t n);
+		void (*axpby)(double* y, double alpha, const double* x, double beta, size_t n);
+
+		/*
+		 * Distances between a and b: sum of |a[i] - b[i]|, sum of (a[i] - b[i])^2 and max of |a[i] - b[i]|
+		 *
+		 * Kernels stop as soon as the partial result reaches limit and return it,
+		 * so the result is exact only when it is below limit
+		 */
+		double (*diffAbsSum)(const double* a, const double* b, size_t n, double limit);
+		double (*diffSquareSum)(const double* a, const double* b, size_t n, double limit);
+		double (*diffAbsMax)(const double* a, const double* b, size_t n, double limit);
+
+		// Index of the first NaN or infinite value, n if there is none
+		size_t (*findNonFinite)(const double* a, size_t n);
+	};
+
+	using InstructionSet = IVector::INSTRUCTION_SET;
+
+	const KernelTable& active();
+
+	/*
+	 * Returns nullptr if the kernels were not compiled in or the CPU does not support them
+	 */
+	const KernelTable* get(InstructionSet set);
+
+	bool setActive(InstructionSet set);
+	InstructionSet activeSet();
+
+	const KernelTable& scalarKernels();
+	const KernelTable* sse2Kernels();
+	const KernelTable* avx2Kernels();
+	const KernelTable* avx512Kernels();
+
+	size_t scalarFindNonFinite(const double* a, size_t n);
+
+} // namespace VectorKernels
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VECTOR_KERNELS_X86
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define VECTOR_TARGET(isa) __attribute__((target(isa)))
+#else
+	#define VECTOR_TARGET(isa)
+#endif
@@ -0,0 +1,340 @@
+#include "VectorKernels.h"
+
+#ifdef VECTOR_KERNELS_X86
+
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include <immintrin.h>
+
+using VectorKernels::KernelTable;
+
+namespace {
+
+	VECTOR_TARGET("avx2,fma") inline double horizontalSum(__m256d x) {
+		__m128d sum = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+	}
+
+	VECTOR_TARGET("avx2,fma") inline double horizontalMax(__m256d x) {
+		__m128d max = _mm_max_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+		return _mm_cvtsd_f64(_mm_max_sd(max, _mm_unpackhi_pd(max, max)));
+	}
+
+	VECTOR_TARGET("avx2,fma") inline __m256d absMask() {
+		return _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	}
+
+	VECTOR_TARGET("avx2,fma") double avx2Dot(const double* a, const double* b, size_t n) {
+		__m256d acc0 = _mm256_setzero_pd();
+		__m256d acc1 = _mm256_setzero_pd();
+		__m256d acc2 = _mm256_setzero_pd();
+		__m256d acc3 = _mm256_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+			acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+			acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), acc2);
+			acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), acc3);
+		}
+		for (; i + 4 <= n; i += 4) {
+			acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+		}
+
+		double res = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+		for (; i < n; i++) {
+			res += a[i] * b[i];
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("avx2,fma") double avx2AbsSum(const double* a, size_t n) {
+		const __m256d mask = absMask();
+		__m256d acc0 = _mm256_setzero_pd();
+		__m256d acc1 = _mm256_setzero_pd();
+		__m256d acc2 = _mm256_setzero_pd();
+		__m256d acc3 = _mm256_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			acc0 = _mm256_add_pd(acc0, _mm256_and_pd(mask, _mm256_loadu_pd(a + i)));
+			acc1 = _mm256_add_pd(acc1, _mm256_and_pd(mask, _mm256_loadu_pd(a + i + 4)));
+			acc2 = _mm256_add_pd(acc2, _mm256_and_pd(mask, _mm256_loadu_pd(a + i + 8)));
+			acc3 = _mm256_add_pd(acc3, _mm256_and_pd(mask, _mm256_loadu_pd(a + i + 12)));
+		}
+		for (; i + 4 <= n; i += 4) {
+			acc0 = _mm256_add_pd(acc0, _mm256_and_pd(mask, _mm256_loadu_pd(a + i)));
+		}
+
+		double res = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+		for (; i < n; i++) {
+			res += a[i] < 0 ? -a[i] : a[i];
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("avx2,fma") double avx2SquareSum(const double* a, size_t n) {
+		__m256d acc0 = _mm256_setzero_pd();
+		__m256d acc1 = _mm256_setzero_pd();
+		__m256d acc2 = _mm256_setzero_pd();
+		__m256d acc3 = _mm256_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			__m256d x0 = _mm256_loadu_pd(a + i);
+			__m256d x1 = _mm256_loadu_pd(a + i + 4);
+			__m256d x2 = _mm256_loadu_pd(a + i + 8);
+			__m256d x3 = _mm256_loadu_pd(a + i + 12);
+			acc0 = _mm256_fmadd_pd(x0, x0, acc0);
+			acc1 = _mm256_fmadd_pd(x1, x1, acc1);
+			acc2 = _mm256_fmadd_pd(x2, x2, acc2);
+			acc3 = _mm256_fmadd_pd(x3, x3, acc3);
+		}
+		for (; i + 4 <= n; i += 4) {
+			__m256d x = _mm256_loadu_pd(a + i);
+			acc0 = _mm256_fmadd_pd(x, x, acc0);
+		}
+
+		double res = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+		for (; i < n; i++) {
+			res += a[i] * a[i];
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("avx2,fma") double avx2AbsMax(const double* a, size_t n) {
+		const __m256d mask = absMask();
+		__m256d acc0 = _mm256_setzero_pd();
+		__m256d acc1 = _mm256_setzero_pd();
+		__m256d nan = _mm256_setzero_pd();
+
+		// max drops NaN, so it is tracked apart
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256d x0 = _mm256_and_pd(mask, _mm256_loadu_pd(a + i));
+			__m256d x1 = _mm256_and_pd(mask, _mm256_loadu_pd(a + i + 4));
+			acc0 = _mm256_max_pd(acc0, x0);
+			acc1 = _mm256_max_pd(acc1, x1);
+			nan = _mm256_or_pd(nan, _mm256_cmp_pd(x0, x1, _CMP_UNORD_Q));
+		}
+
+		if (_mm256_movemask_pd(nan)) {
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+
+		double res = horizontalMax(_mm256_max_pd(acc0, acc1));
+		for (; i < n && !std::isnan(res); i++) {
+			double x = a[i] < 0 ? -a[i] : a[i];
+			if (!(x <= res)) {
+				res = x;
+			}
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("avx2,fma") void avx2Add(double* dst, const double* src, size_t n) {
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(dst + i), _mm256_loadu_pd(src + i)));
+			_mm256_storeu_pd(dst + i + 4,
+							 _mm256_add_pd(_mm256_loadu_pd(dst + i + 4), _mm256_loadu_pd(src + i + 4)));
+		}
+		for (; i < n; i++) {
+			dst[i] += src[i];
+		}
+	}
+
+	VECTOR_TARGET("avx2,fma") void avx2Sub(double* dst, const double* src, size_t n) {
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm256_storeu_pd(dst + i, _mm256_sub_pd(_mm256_loadu_pd(dst + i), _mm256_loadu_pd(src + i)));
+			_mm256_storeu_pd(dst + i + 4,
+							 _mm256_sub_pd(_mm256_loadu_pd(dst + i + 4), _mm256_loadu_pd(src + i + 4)));
+		}
+		for (; i < n; i++) {
+			dst[i] -= src[i];
+		}
+	}
+
+	VECTOR_TARGET("avx2,fma") void avx2Scale(double* a, double multiplier, size_t n) {
+		const __m256d m = _mm256_set1_pd(multiplier);
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm256_storeu_pd(a + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), m));
+			_mm256_storeu_pd(a + i + 4, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), m));
+		}
+		for (; i < n; i++) {
+			a[i] *= multiplier;
+		}
+	}
+
+	VECTOR_TARGET("avx2,fma") void avx2Axpy(double* y, double alpha, const double* x, size_t n) {
+		const __m256d a = _mm256_set1_pd(alpha);
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+			_mm256_storeu_pd(y + i + 4, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+		}
+		for (; i < n; i++) {
+			y[i] += alpha * x[i];
+		}
+	}
+
+	VECTOR_TARGET("avx2,fma") void avx2Axpby(double* y, double alpha, const double* x, double beta, size_t n) {
+		const __m256d a = _mm256_set1_pd(alpha);
+		const __m256d b = _mm256_set1_pd(beta);
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm256_storeu_pd(y + i,
+							 _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_mul_pd(b, _mm256_loadu_pd(y + i))));
+			_mm256_storeu_pd(y + i + 4,
+							 _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i + 4), _mm256_mul_pd(b, _mm256_loadu_pd(y + i + 4))));
+		}
+		for (; i < n; i++) {
+			y[i] = alpha * x[i] + beta * y[i];
+		}
+	}
+
+	VECTOR_TARGET("avx2,fma") double avx2DiffAbsSum(const double* a, const double* b, size_t n, double limit) {
+		const __m256d mask = absMask();
+		__m256d acc0 = _mm256_setzero_pd();
+		__m256d acc1 = _mm256_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			acc0 = _mm256_add_pd(acc0, _mm256_and_pd(mask, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i))));
+			acc1 = _mm256_add_pd(acc1,
+								 _mm256_and_pd(mask, _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4))));
+			acc0 = _mm256_add_pd(acc0,
+								 _mm256_and_pd(mask, _mm256_sub_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8))));
+			acc1 = _mm256_add_pd(acc1,
+								 _mm256_and_pd(mask, _mm256_sub_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12))));
+
+			double partial = horizontalSum(_mm256_add_pd(acc0, acc1));
+			if (!(partial < limit)) {
+				return partial;
+			}
+		}
+		for (; i + 4 <= n; i += 4) {
+			acc0 = _mm256_add_pd(acc0, _mm256_and_pd(mask, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i))));
+		}
+
+		double res = horizontalSum(_mm256_add_pd(acc0, acc1));
+		for (; i < n && res < limit; i++) {
+			double diff = a[i] - b[i];
+			res += diff < 0 ? -diff : diff;
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("avx2,fma") double avx2DiffSquareSum(const double* a, const double* b, size_t n, double limit) {
+		__m256d acc0 = _mm256_setzero_pd();
+		__m256d acc1 = _mm256_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			__m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+			__m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+			__m256d d2 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8));
+			__m256d d3 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12));
+			acc0 = _mm256_fmadd_pd(d0, d0, acc0);
+			acc1 = _mm256_fmadd_pd(d1, d1, acc1);
+			acc0 = _mm256_fmadd_pd(d2, d2, acc0);
+			acc1 = _mm256_fmadd_pd(d3, d3, acc1);
+
+			double partial = horizontalSum(_mm256_add_pd(acc0, acc1));
+			if (!(partial < limit)) {
+				return partial;
+			}
+		}
+		for (; i + 4 <= n; i += 4) {
+			__m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+			acc0 = _mm256_fmadd_pd(d, d, acc0);
+		}
+
+		double res = horizontalSum(_mm256_add_pd(acc0, acc1));
+		for (; i < n && res < limit; i++) {
+			double diff = a[i] - b[i];
+			res += diff * diff;
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("avx2,fma") double avx2DiffAbsMax(const double* a, const double* b, size_t n, double limit) {
+		const __m256d mask = absMask();
+		const __m256d lim = _mm256_set1_pd(limit);
+		__m256d acc = _mm256_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256d diff = _mm256_and_pd(mask, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+			acc = _mm256_max_pd(acc, diff);
+
+			// Not-less-than with unordered predicate also stops on NaN, which max may have dropped
+			if (_mm256_movemask_pd(_mm256_cmp_pd(diff, lim, _CMP_NLT_UQ))) {
+				if (_mm256_movemask_pd(_mm256_cmp_pd(diff, diff, _CMP_UNORD_Q))) {
+					return std::numeric_limits<double>::quiet_NaN();
+				}
+				return horizontalMax(acc);
+			}
+		}
+
+		double res = horizontalMax(acc);
+		for (; i < n && res < limit; i++) {
+			double diff = a[i] - b[i];
+			diff = diff < 0 ? -diff : diff;
+			res = !(diff <= res) ? diff : res;
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("avx2,fma") size_t avx2FindNonFinite(const double* a, size_t n) {
+		const __m256d mask = absMask();
+		const __m256d maxFinite = _mm256_set1_pd(DBL_MAX);
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256d abs0 = _mm256_and_pd(mask, _mm256_loadu_pd(a + i));
+			__m256d abs1 = _mm256_and_pd(mask, _mm256_loadu_pd(a + i + 4));
+
+			// Not-less-or-equal with unordered predicate also catches NaN
+			__m256d bad = _mm256_or_pd(_mm256_cmp_pd(abs0, maxFinite, _CMP_NLE_UQ),
+									   _mm256_cmp_pd(abs1, maxFinite, _CMP_NLE_UQ));
+
+			if (_mm256_movemask_pd(bad)) {
+				return i + VectorKernels::scalarFindNonFinite(a + i, 8);
+			}
+		}
+		return i + VectorKernels::scalarFindNonFinite(a + i, n - i);
+	}
+
+	const KernelTable s_avx2Kernels = {
+		avx2Dot,
+		avx2AbsSum,
+		avx2SquareSum,
+		avx2AbsMax,
+		avx2Add,
+		avx2Sub,
+		avx2Scale,
+		avx2Axpy,
+		avx2Axpby,
+		avx2DiffAbsSum,
+		avx2DiffSquareSum,
+		avx2DiffAbsMax,
+		avx2FindNonFinite,
+	};
+
+} // namespace
+
+const KernelTable* VectorKernels::avx2Kernels() { return &s_avx2Kernels; }
+
+#else
+
+const VectorKernels::KernelTable* VectorKernels::avx2Kernels() { return nullptr; }
+
+#endif
@@ -0,0 +1,324 @@
+#include "VectorKernels.h"
+
+#ifdef VECTOR_KERNELS_X86
+
+#include <cfloat>
+#include <limits>
+
+#include <immintrin.h>
+
+using VectorKernels::KernelTable;
+
+namespace {
+
+	VECTOR_TARGET("avx512f") inline __m512d absValue(__m512d x) {
+		return _mm512_castsi512_pd(
+			_mm512_and_epi64(_mm512_castpd_si512(x), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)));
+	}
+
+	VECTOR_TARGET("avx512f") double avx512Dot(const double* a, const double* b, size_t n) {
+		__m512d acc0 = _mm512_setzero_pd();
+		__m512d acc1 = _mm512_setzero_pd();
+		__m512d acc2 = _mm512_setzero_pd();
+		__m512d acc3 = _mm512_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+			acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+			acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), acc2);
+			acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), acc3);
+		}
+		for (; i + 8 <= n; i += 8) {
+			acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, a + i), _mm512_maskz_loadu_pd(tail, b + i), acc1);
+		}
+
+		return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+	}
+
+	VECTOR_TARGET("avx512f") double avx512AbsSum(const double* a, size_t n) {
+		__m512d acc0 = _mm512_setzero_pd();
+		__m512d acc1 = _mm512_setzero_pd();
+		__m512d acc2 = _mm512_setzero_pd();
+		__m512d acc3 = _mm512_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			acc0 = _mm512_add_pd(acc0, absValue(_mm512_loadu_pd(a + i)));
+			acc1 = _mm512_add_pd(acc1, absValue(_mm512_loadu_pd(a + i + 8)));
+			acc2 = _mm512_add_pd(acc2, absValue(_mm512_loadu_pd(a + i + 16)));
+			acc3 = _mm512_add_pd(acc3, absValue(_mm512_loadu_pd(a + i + 24)));
+		}
+		for (; i + 8 <= n; i += 8) {
+			acc0 = _mm512_add_pd(acc0, absValue(_mm512_loadu_pd(a + i)));
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			acc1 = _mm512_add_pd(acc1, absValue(_mm512_maskz_loadu_pd(tail, a + i)));
+		}
+
+		return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+	}
+
+	VECTOR_TARGET("avx512f") double avx512SquareSum(const double* a, size_t n) {
+		__m512d acc0 = _mm512_setzero_pd();
+		__m512d acc1 = _mm512_setzero_pd();
+		__m512d acc2 = _mm512_setzero_pd();
+		__m512d acc3 = _mm512_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			__m512d x0 = _mm512_loadu_pd(a + i);
+			__m512d x1 = _mm512_loadu_pd(a + i + 8);
+			__m512d x2 = _mm512_loadu_pd(a + i + 16);
+			__m512d x3 = _mm512_loadu_pd(a + i + 24);
+			acc0 = _mm512_fmadd_pd(x0, x0, acc0);
+			acc1 = _mm512_fmadd_pd(x1, x1, acc1);
+			acc2 = _mm512_fmadd_pd(x2, x2, acc2);
+			acc3 = _mm512_fmadd_pd(x3, x3, acc3);
+		}
+		for (; i + 8 <= n; i += 8) {
+			__m512d x = _mm512_loadu_pd(a + i);
+			acc0 = _mm512_fmadd_pd(x, x, acc0);
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d x = _mm512_maskz_loadu_pd(tail, a + i);
+			acc1 = _mm512_fmadd_pd(x, x, acc1);
+		}
+
+		return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+	}
+
+	VECTOR_TARGET("avx512f") double avx512AbsMax(const double* a, size_t n) {
+		__m512d acc0 = _mm512_setzero_pd();
+		__m512d acc1 = _mm512_setzero_pd();
+		__mmask8 nan = 0;
+
+		// max drops NaN, so it is tracked apart
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			__m512d x0 = absValue(_mm512_loadu_pd(a + i));
+			__m512d x1 = absValue(_mm512_loadu_pd(a + i + 8));
+			acc0 = _mm512_max_pd(acc0, x0);
+			acc1 = _mm512_max_pd(acc1, x1);
+			nan |= _mm512_cmp_pd_mask(x0, x1, _CMP_UNORD_Q);
+		}
+		for (; i + 8 <= n; i += 8) {
+			__m512d x = absValue(_mm512_loadu_pd(a + i));
+			acc0 = _mm512_max_pd(acc0, x);
+			nan |= _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q);
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d x = absValue(_mm512_maskz_loadu_pd(tail, a + i));
+			acc1 = _mm512_max_pd(acc1, x);
+			nan |= _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q);
+		}
+
+		if (nan) {
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		return _mm512_reduce_max_pd(_mm512_max_pd(acc0, acc1));
+	}
+
+	VECTOR_TARGET("avx512f") void avx512Add(double* dst, const double* src, size_t n) {
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm512_storeu_pd(dst + i, _mm512_add_pd(_mm512_loadu_pd(dst + i), _mm512_loadu_pd(src + i)));
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d sum = _mm512_add_pd(_mm512_maskz_loadu_pd(tail, dst + i), _mm512_maskz_loadu_pd(tail, src + i));
+			_mm512_mask_storeu_pd(dst + i, tail, sum);
+		}
+	}
+
+	VECTOR_TARGET("avx512f") void avx512Sub(double* dst, const double* src, size_t n) {
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm512_storeu_pd(dst + i, _mm512_sub_pd(_mm512_loadu_pd(dst + i), _mm512_loadu_pd(src + i)));
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(tail, dst + i), _mm512_maskz_loadu_pd(tail, src + i));
+			_mm512_mask_storeu_pd(dst + i, tail, diff);
+		}
+	}
+
+	VECTOR_TARGET("avx512f") void avx512Scale(double* a, double multiplier, size_t n) {
+		const __m512d m = _mm512_set1_pd(multiplier);
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm512_storeu_pd(a + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), m));
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			_mm512_mask_storeu_pd(a + i, tail, _mm512_mul_pd(_mm512_maskz_loadu_pd(tail, a + i), m));
+		}
+	}
+
+	VECTOR_TARGET("avx512f") void avx512Axpy(double* y, double alpha, const double* x, size_t n) {
+		const __m512d a = _mm512_set1_pd(alpha);
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm512_storeu_pd(y + i, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d res = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(tail, x + i), _mm512_maskz_loadu_pd(tail, y + i));
+			_mm512_mask_storeu_pd(y + i, tail, res);
+		}
+	}
+
+	VECTOR_TARGET("avx512f") void avx512Axpby(double* y, double alpha, const double* x, double beta, size_t n) {
+		const __m512d a = _mm512_set1_pd(alpha);
+		const __m512d b = _mm512_set1_pd(beta);
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			_mm512_storeu_pd(y + i,
+							 _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_mul_pd(b, _mm512_loadu_pd(y + i))));
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d by = _mm512_mul_pd(b, _mm512_maskz_loadu_pd(tail, y + i));
+			_mm512_mask_storeu_pd(y + i, tail, _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(tail, x + i), by));
+		}
+	}
+
+	VECTOR_TARGET("avx512f") double avx512DiffAbsSum(const double* a, const double* b, size_t n, double limit) {
+		__m512d acc0 = _mm512_setzero_pd();
+		__m512d acc1 = _mm512_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			acc0 = _mm512_add_pd(acc0, absValue(_mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i))));
+			acc1 = _mm512_add_pd(acc1, absValue(_mm512_sub_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8))));
+			acc0 = _mm512_add_pd(acc0, absValue(_mm512_sub_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16))));
+			acc1 = _mm512_add_pd(acc1, absValue(_mm512_sub_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24))));
+
+			double partial = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+			if (!(partial < limit)) {
+				return partial;
+			}
+		}
+		for (; i + 8 <= n; i += 8) {
+			acc0 = _mm512_add_pd(acc0, absValue(_mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i))));
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(tail, a + i), _mm512_maskz_loadu_pd(tail, b + i));
+			acc1 = _mm512_add_pd(acc1, absValue(diff));
+		}
+
+		return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+	}
+
+	VECTOR_TARGET("avx512f") double avx512DiffSquareSum(const double* a, const double* b, size_t n, double limit) {
+		__m512d acc0 = _mm512_setzero_pd();
+		__m512d acc1 = _mm512_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			__m512d d0 = _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+			__m512d d1 = _mm512_sub_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8));
+			__m512d d2 = _mm512_sub_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16));
+			__m512d d3 = _mm512_sub_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24));
+			acc0 = _mm512_fmadd_pd(d0, d0, acc0);
+			acc1 = _mm512_fmadd_pd(d1, d1, acc1);
+			acc0 = _mm512_fmadd_pd(d2, d2, acc0);
+			acc1 = _mm512_fmadd_pd(d3, d3, acc1);
+
+			double partial = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+			if (!(partial < limit)) {
+				return partial;
+			}
+		}
+		for (; i + 8 <= n; i += 8) {
+			__m512d d = _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+			acc0 = _mm512_fmadd_pd(d, d, acc0);
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d d = _mm512_sub_pd(_mm512_maskz_loadu_pd(tail, a + i), _mm512_maskz_loadu_pd(tail, b + i));
+			acc1 = _mm512_fmadd_pd(d, d, acc1);
+		}
+
+		return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+	}
+
+	VECTOR_TARGET("avx512f") double avx512DiffAbsMax(const double* a, const double* b, size_t n, double limit) {
+		const __m512d lim = _mm512_set1_pd(limit);
+		__m512d acc = _mm512_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m512d diff = absValue(_mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+			acc = _mm512_max_pd(acc, diff);
+
+			// Not-less-than with unordered predicate also stops on NaN, which max may have dropped
+			if (_mm512_cmp_pd_mask(diff, lim, _CMP_NLT_UQ)) {
+				if (_mm512_cmp_pd_mask(diff, diff, _CMP_UNORD_Q)) {
+					return std::numeric_limits<double>::quiet_NaN();
+				}
+				return _mm512_reduce_max_pd(acc);
+			}
+		}
+		if (i < n) {
+			__mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+			__m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(tail, a + i), _mm512_maskz_loadu_pd(tail, b + i));
+			if (_mm512_cmp_pd_mask(diff, diff, _CMP_UNORD_Q)) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			acc = _mm512_max_pd(acc, absValue(diff));
+		}
+
+		return _mm512_reduce_max_pd(acc);
+	}
+
+	VECTOR_TARGET("avx512f") size_t avx512FindNonFinite(const double* a, size_t n) {
+		const __m512d maxFinite = _mm512_set1_pd(DBL_MAX);
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			// Not-less-or-equal with unordered predicate also catches NaN
+			__mmask8 bad = _mm512_cmp_pd_mask(absValue(_mm512_loadu_pd(a + i)), maxFinite, _CMP_NLE_UQ);
+			if (bad) {
+				return i + VectorKernels::scalarFindNonFinite(a + i, 8);
+			}
+		}
+		return i + VectorKernels::scalarFindNonFinite(a + i, n - i);
+	}
+
+	const KernelTable s_avx512Kernels = {
+		avx512Dot,
+		avx512AbsSum,
+		avx512SquareSum,
+		avx512AbsMax,
+		avx512Add,
+		avx512Sub,
+		avx512Scale,
+		avx512Axpy,
+		avx512Axpby,
+		avx512DiffAbsSum,
+		avx512DiffSquareSum,
+		avx512DiffAbsMax,
+		avx512FindNonFinite,
+	};
+
+} // namespace
+
+const KernelTable* VectorKernels::avx512Kernels() { return &s_avx512Kernels; }
+
+#else
+
+const VectorKernels::KernelTable* VectorKernels::avx512Kernels() { return nullptr; }
+
+#endif
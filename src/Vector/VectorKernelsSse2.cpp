@@ -0,0 +1,309 @@
+#include "VectorKernels.h"
+
+#ifdef VECTOR_KERNELS_X86
+
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include <emmintrin.h>
+
+using VectorKernels::KernelTable;
+
+namespace {
+
+	VECTOR_TARGET("sse2") inline double horizontalSum(__m128d x) {
+		return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+	}
+
+	VECTOR_TARGET("sse2") inline double horizontalMax(__m128d x) {
+		return _mm_cvtsd_f64(_mm_max_sd(x, _mm_unpackhi_pd(x, x)));
+	}
+
+	VECTOR_TARGET("sse2") inline __m128d absMask() {
+		return _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	}
+
+	VECTOR_TARGET("sse2") double sse2Dot(const double* a, const double* b, size_t n) {
+		__m128d acc0 = _mm_setzero_pd();
+		__m128d acc1 = _mm_setzero_pd();
+		__m128d acc2 = _mm_setzero_pd();
+		__m128d acc3 = _mm_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+			acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+			acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+		}
+
+		double res = horizontalSum(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+		for (; i < n; i++) {
+			res += a[i] * b[i];
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("sse2") double sse2AbsSum(const double* a, size_t n) {
+		const __m128d mask = absMask();
+		__m128d acc0 = _mm_setzero_pd();
+		__m128d acc1 = _mm_setzero_pd();
+		__m128d acc2 = _mm_setzero_pd();
+		__m128d acc3 = _mm_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			acc0 = _mm_add_pd(acc0, _mm_and_pd(mask, _mm_loadu_pd(a + i)));
+			acc1 = _mm_add_pd(acc1, _mm_and_pd(mask, _mm_loadu_pd(a + i + 2)));
+			acc2 = _mm_add_pd(acc2, _mm_and_pd(mask, _mm_loadu_pd(a + i + 4)));
+			acc3 = _mm_add_pd(acc3, _mm_and_pd(mask, _mm_loadu_pd(a + i + 6)));
+		}
+
+		double res = horizontalSum(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+		for (; i < n; i++) {
+			res += a[i] < 0 ? -a[i] : a[i];
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("sse2") double sse2SquareSum(const double* a, size_t n) {
+		__m128d acc0 = _mm_setzero_pd();
+		__m128d acc1 = _mm_setzero_pd();
+		__m128d acc2 = _mm_setzero_pd();
+		__m128d acc3 = _mm_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m128d x0 = _mm_loadu_pd(a + i);
+			__m128d x1 = _mm_loadu_pd(a + i + 2);
+			__m128d x2 = _mm_loadu_pd(a + i + 4);
+			__m128d x3 = _mm_loadu_pd(a + i + 6);
+			acc0 = _mm_add_pd(acc0, _mm_mul_pd(x0, x0));
+			acc1 = _mm_add_pd(acc1, _mm_mul_pd(x1, x1));
+			acc2 = _mm_add_pd(acc2, _mm_mul_pd(x2, x2));
+			acc3 = _mm_add_pd(acc3, _mm_mul_pd(x3, x3));
+		}
+
+		double res = horizontalSum(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+		for (; i < n; i++) {
+			res += a[i] * a[i];
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("sse2") double sse2AbsMax(const double* a, size_t n) {
+		const __m128d mask = absMask();
+		__m128d acc0 = _mm_setzero_pd();
+		__m128d acc1 = _mm_setzero_pd();
+		__m128d nan = _mm_setzero_pd();
+
+		// max drops NaN, so it is tracked apart
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m128d x0 = _mm_and_pd(mask, _mm_loadu_pd(a + i));
+			__m128d x1 = _mm_and_pd(mask, _mm_loadu_pd(a + i + 2));
+			acc0 = _mm_max_pd(acc0, x0);
+			acc1 = _mm_max_pd(acc1, x1);
+			nan = _mm_or_pd(nan, _mm_cmpunord_pd(x0, x1));
+		}
+
+		if (_mm_movemask_pd(nan)) {
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+
+		double res = horizontalMax(_mm_max_pd(acc0, acc1));
+		for (; i < n && !std::isnan(res); i++) {
+			double x = a[i] < 0 ? -a[i] : a[i];
+			if (!(x <= res)) {
+				res = x;
+			}
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("sse2") void sse2Add(double* dst, const double* src, size_t n) {
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			_mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+			_mm_storeu_pd(dst + i + 2, _mm_add_pd(_mm_loadu_pd(dst + i + 2), _mm_loadu_pd(src + i + 2)));
+		}
+		for (; i < n; i++) {
+			dst[i] += src[i];
+		}
+	}
+
+	VECTOR_TARGET("sse2") void sse2Sub(double* dst, const double* src, size_t n) {
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			_mm_storeu_pd(dst + i, _mm_sub_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+			_mm_storeu_pd(dst + i + 2, _mm_sub_pd(_mm_loadu_pd(dst + i + 2), _mm_loadu_pd(src + i + 2)));
+		}
+		for (; i < n; i++) {
+			dst[i] -= src[i];
+		}
+	}
+
+	VECTOR_TARGET("sse2") void sse2Scale(double* a, double multiplier, size_t n) {
+		const __m128d m = _mm_set1_pd(multiplier);
+
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			_mm_storeu_pd(a + i, _mm_mul_pd(_mm_loadu_pd(a + i), m));
+			_mm_storeu_pd(a + i + 2, _mm_mul_pd(_mm_loadu_pd(a + i + 2), m));
+		}
+		for (; i < n; i++) {
+			a[i] *= multiplier;
+		}
+	}
+
+	VECTOR_TARGET("sse2") void sse2Axpy(double* y, double alpha, const double* x, size_t n) {
+		const __m128d a = _mm_set1_pd(alpha);
+
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			_mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a, _mm_loadu_pd(x + i))));
+			_mm_storeu_pd(y + i + 2, _mm_add_pd(_mm_loadu_pd(y + i + 2), _mm_mul_pd(a, _mm_loadu_pd(x + i + 2))));
+		}
+		for (; i < n; i++) {
+			y[i] += alpha * x[i];
+		}
+	}
+
+	VECTOR_TARGET("sse2") void sse2Axpby(double* y, double alpha, const double* x, double beta, size_t n) {
+		const __m128d a = _mm_set1_pd(alpha);
+		const __m128d b = _mm_set1_pd(beta);
+
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			_mm_storeu_pd(y + i,
+						  _mm_add_pd(_mm_mul_pd(a, _mm_loadu_pd(x + i)), _mm_mul_pd(b, _mm_loadu_pd(y + i))));
+			_mm_storeu_pd(y + i + 2,
+						  _mm_add_pd(_mm_mul_pd(a, _mm_loadu_pd(x + i + 2)), _mm_mul_pd(b, _mm_loadu_pd(y + i + 2))));
+		}
+		for (; i < n; i++) {
+			y[i] = alpha * x[i] + beta * y[i];
+		}
+	}
+
+	VECTOR_TARGET("sse2") double sse2DiffAbsSum(const double* a, const double* b, size_t n, double limit) {
+		const __m128d mask = absMask();
+		__m128d acc0 = _mm_setzero_pd();
+		__m128d acc1 = _mm_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			acc0 = _mm_add_pd(acc0, _mm_and_pd(mask, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i))));
+			acc1 = _mm_add_pd(acc1, _mm_and_pd(mask, _mm_sub_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2))));
+			acc0 = _mm_add_pd(acc0, _mm_and_pd(mask, _mm_sub_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4))));
+			acc1 = _mm_add_pd(acc1, _mm_and_pd(mask, _mm_sub_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6))));
+
+			if (!(horizontalSum(_mm_add_pd(acc0, acc1)) < limit)) {
+				return horizontalSum(_mm_add_pd(acc0, acc1));
+			}
+		}
+
+		double res = horizontalSum(_mm_add_pd(acc0, acc1));
+		for (; i < n && res < limit; i++) {
+			double diff = a[i] - b[i];
+			res += diff < 0 ? -diff : diff;
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("sse2") double sse2DiffSquareSum(const double* a, const double* b, size_t n, double limit) {
+		__m128d acc0 = _mm_setzero_pd();
+		__m128d acc1 = _mm_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m128d d0 = _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+			__m128d d1 = _mm_sub_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2));
+			__m128d d2 = _mm_sub_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4));
+			__m128d d3 = _mm_sub_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6));
+			acc0 = _mm_add_pd(acc0, _mm_add_pd(_mm_mul_pd(d0, d0), _mm_mul_pd(d2, d2)));
+			acc1 = _mm_add_pd(acc1, _mm_add_pd(_mm_mul_pd(d1, d1), _mm_mul_pd(d3, d3)));
+
+			if (!(horizontalSum(_mm_add_pd(acc0, acc1)) < limit)) {
+				return horizontalSum(_mm_add_pd(acc0, acc1));
+			}
+		}
+
+		double res = horizontalSum(_mm_add_pd(acc0, acc1));
+		for (; i < n && res < limit; i++) {
+			double diff = a[i] - b[i];
+			res += diff * diff;
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("sse2") double sse2DiffAbsMax(const double* a, const double* b, size_t n, double limit) {
+		const __m128d mask = absMask();
+		const __m128d lim = _mm_set1_pd(limit);
+		__m128d acc = _mm_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2) {
+			__m128d diff = _mm_and_pd(mask, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			acc = _mm_max_pd(acc, diff);
+
+			// Not-less-than with unordered predicate also stops on NaN, which max may have dropped
+			if (_mm_movemask_pd(_mm_cmpnlt_pd(diff, lim))) {
+				if (_mm_movemask_pd(_mm_cmpunord_pd(diff, diff))) {
+					return std::numeric_limits<double>::quiet_NaN();
+				}
+				return horizontalMax(acc);
+			}
+		}
+
+		double res = horizontalMax(acc);
+		if (i < n) {
+			double diff = a[i] - b[i];
+			diff = diff < 0 ? -diff : diff;
+			res = !(diff <= res) ? diff : res;
+		}
+		return res;
+	}
+
+	VECTOR_TARGET("sse2") size_t sse2FindNonFinite(const double* a, size_t n) {
+		const __m128d mask = absMask();
+		const __m128d maxFinite = _mm_set1_pd(DBL_MAX);
+
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			// cmpnle is true for NaN as well as for values above DBL_MAX
+			__m128d bad0 = _mm_cmpnle_pd(_mm_and_pd(mask, _mm_loadu_pd(a + i)), maxFinite);
+			__m128d bad1 = _mm_cmpnle_pd(_mm_and_pd(mask, _mm_loadu_pd(a + i + 2)), maxFinite);
+
+			if (_mm_movemask_pd(_mm_or_pd(bad0, bad1))) {
+				return i + VectorKernels::scalarFindNonFinite(a + i, 4);
+			}
+		}
+		return i + VectorKernels::scalarFindNonFinite(a + i, n - i);
+	}
+
+	const KernelTable s_sse2Kernels = {
+		sse2Dot,
+		sse2AbsSum,
+		sse2SquareSum,
+		sse2AbsMax,
+		sse2Add,
+		sse2Sub,
+		sse2Scale,
+		sse2Axpy,
+		sse2Axpby,
+		sse2DiffAbsSum,
+		sse2DiffSquareSum,
+		sse2DiffAbsMax,
+		sse2FindNonFinite,
+	};
+
+} // namespace
+
+const KernelTable* VectorKernels::sse2Kernels() { return &s_sse2Kernels; }
+
+#else
+
+const VectorKernels::KernelTable* VectorKernels::sse2Kernels() { return nullptr; }
+
+#endif
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "VectorParallel.h"
+#include "VectorSummation.h"
+
+using VectorParallel::CHUNK_SIZE;
+
+namespace {
+
+	// 4M coordinates, below it the cost of waking threads is comparable to the work itself
+	const size_t DEFAULT_THRESHOLD = 4 * 1024 * 1024;
+
+	size_t defaultMaxThreads() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+	std::atomic<size_t> s_threshold(DEFAULT_THRESHOLD);
+	std::atomic<size_t> s_maxThreads(defaultMaxThreads());
+
+	size_t chunksNumber(size_t n) { return (n + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+
+	class ThreadPool {
+	public:
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_wake.notify_all();
+
+			for (auto& worker : m_workers) {
+				worker.join();
+			}
+		}
+
+		void run(size_t count, const std::function<void(size_t)>& fun) {
+			size_t helpers = std::min(s_maxThreads.load(std::memory_order_relaxed), count) - 1;
+
+			// One job at a time, concurrent callers don't wait for each other
+			std::unique_lock<std::mutex> jobLock(m_jobMutex, std::try_to_lock);
+			if (helpers == 0 || !jobLock.owns_lock()) {
+				for (size_t chunk = 0; chunk < count; chunk++) {
+					fun(chunk);
+				}
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (m_workers.size() < helpers) {
+				m_workers.emplace_back(&ThreadPool::workerLoop, this, m_workers.size());
+			}
+
+			m_job = &fun;
+			m_count = count;
+			m_next.store(0, std::memory_order_relaxed);
+			m_helpers = helpers;
+			m_running = helpers;
+			m_generation++;
+			lock.unlock();
+			m_wake.notify_all();
+
+			process();
+
+			lock.lock();
+			m_done.wait(lock, [this] { return m_running == 0; });
+			m_job = nullptr;
+		}
+
+	private:
+		void process() {
+			for (size_t chunk = m_next.fetch_add(1); chunk < m_count; chunk = m_next.fetch_add(1)) {
+				(*m_job)(chunk);
+			}
+		}
+
+		void workerLoop(size_t index) {
+			size_t seenGeneration = 0;
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			while (true) {
+				m_wake.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+				if (m_stop) {
+					return;
+				}
+				seenGeneration = m_generation;
+
+				// Pool may have more workers than the current thread cap
+				if (index >= m_helpers) {
+					continue;
+				}
+
+				lock.unlock();
+				process();
+				lock.lock();
+
+				if (--m_running == 0) {
+					m_done.notify_one();
+				}
+			}
+		}
+
+		std::mutex m_jobMutex;
+
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		std::vector<std::thread> m_workers;
+
+		const std::function<void(size_t)>* m_job = nullptr;
+		size_t m_count = 0;
+		std::atomic<size_t> m_next{ 0 };
+		size_t m_helpers = 0;
+		size_t m_running = 0;
+		size_t m_generation = 0;
+		bool m_stop = false;
+	};
+
+	ThreadPool& threadPool() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+} // namespace
+
+bool VectorParallel::isEnabled(size_t n) { return n >= s_threshold.load(std::memory_order_relaxed); }
+
+void VectorParallel::run(size_t count, const std::function<void(size_t)>& fun) {
+	if (count != 0) {
+		threadPool().run(count, fun);
+	}
+}
+
+double VectorParallel::sum(size_t n, const std::function<double(size_t, size_t)>& partial) {
+	std::vector<double> partials(chunksNumber(n));
+
+	run(partials.size(), [&](size_t chunk) {
+		size_t begin = chunk * CHUNK_SIZE;
+		partials[chunk] = partial(begin, std::min(CHUNK_SIZE, n - begin));
+	});
+
+	VectorSummation::Accumulator acc;
+	for (double value : partials) {
+		acc.add(value);
+	}
+	return acc.result();
+}
+
+double VectorParallel::max(size_t n, const std::function<double(size_t, size_t)>& partial) {
+	std::vector<double> partials(chunksNumber(n));
+
+	run(partials.size(), [&](size_t chunk) {
+		size_t begin = chunk * CHUNK_SIZE;
+		partials[chunk] = partial(begin, std::min(CHUNK_SIZE, n - begin));
+	});
+
+	// Unlike fmax keeps NaN of any chunk
+	double res = 0;
+	for (double value : partials) {
+		if (!(value <= res) && !std::isnan(res)) {
+			res = value;
+		}
+	}
+	return res;
+}
+
+void VectorParallel::forEach(size_t n, const std::function<void(size_t, size_t)>& fun) {
+	run(chunksNumber(n), [&](size_t chunk) {
+		size_t begin = chunk * CHUNK_SIZE;
+		fun(begin, std::min(CHUNK_SIZE, n - begin));
+	});
+}
+
+size_t VectorParallel::getThreshold() { return s_threshold.load(std::memory_order_relaxed); }
+
+void VectorParallel::setThreshold(size_t dim) { s_threshold.store(dim, std::memory_order_relaxed); }
+
+size_t VectorParallel::getMaxThreads() { return s_maxThreads.load(std::memory_order_relaxed); }
+
+void VectorParallel::setMaxThreads(size_t count) { s_maxThreads.store(count, std::memory_order_relaxed); }
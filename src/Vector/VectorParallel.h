@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/*
+ * Shared pool of worker threads for operations on very large vectors
+ *
+ * Work is always split into chunks of CHUNK_SIZE coordinates, independently of the number of threads,
+ * so reductions combining per-chunk results in chunk order give the same value with any thread count
+ */
+namespace VectorParallel {
+
+	// 256 KB of doubles, fits into L2 of a single core
+	const size_t CHUNK_SIZE = 32 * 1024;
+
+	/*
+	 * Whether operation over n coordinates should go through run()
+	 */
+	bool isEnabled(size_t n);
+
+	/*
+	 * Calls fun(chunk) for every chunk in [0, count) on pool threads and the calling one,
+	 * returns after all of them are done. Runs on the calling thread only if pool is busy with another job
+	 */
+	void run(size_t count, const std::function<void(size_t chunk)>& fun);
+
+	/*
+	 * Sum of partial(begin, len) over chunks of [0, n), added in chunk order with compensation
+	 */
+	double sum(size_t n, const std::function<double(size_t begin, size_t len)>& partial);
+
+	/*
+	 * Max of partial(begin, len) over chunks of [0, n)
+	 */
+	double max(size_t n, const std::function<double(size_t begin, size_t len)>& partial);
+
+	/*
+	 * Calls fun(begin, len) for every chunk of [0, n)
+	 */
+	void forEach(size_t n, const std::function<void(size_t begin, size_t len)>& fun);
+
+	/*
+	 * Same as above for vectors past the threshold, smaller ones are processed as a single range
+	 * on the calling thread
+	 */
+	template<class Partial>
+	double reduceSum(size_t n, Partial partial) {
+		return isEnabled(n) ? sum(n, partial) : partial(0, n);
+	}
+
+	template<class Partial>
+	double reduceMax(size_t n, Partial partial) {
+		return isEnabled(n) ? max(n, partial) : partial(0, n);
+	}
+
+	template<class Function>
+	void apply(size_t n, Function fun) {
+		if (isEnabled(n)) {
+			forEach(n, fun);
+		} else {
+			fun(0, n);
+		}
+	}
+
+	size_t getThreshold();
+	void setThreshold(size_t dim);
+
+	size_t getMaxThreads();
+	void setMaxThreads(size_t count);
+
+} // namespace VectorParallel
@@ -0,0 +1,45 @@
+#include <atomic>
+
+#include "LogUtils.h"
+#include "VectorKernels.h"
+#include "VectorSummation.h"
+
+namespace {
+
+	std::atomic<VectorSummation::Mode> s_mode(VectorSummation::Mode::PAIRWISE);
+
+} // namespace
+
+VectorSummation::Mode VectorSummation::getMode() { return s_mode.load(std::memory_order_relaxed); }
+
+void VectorSummation::setMode(Mode mode) { s_mode.store(mode, std::memory_order_relaxed); }
+
+double VectorSummation::dot(const double* a, const double* b, size_t n) {
+	auto& kernels = VectorKernels::active();
+	return sum(n, [&](size_t begin, size_t len) { return kernels.dot(a + begin, b + begin, len); },
+			   [&](size_t i) { return a[i] * b[i]; });
+}
+
+double VectorSummation::absSum(const double* a, size_t n) {
+	auto& kernels = VectorKernels::active();
+	return sum(n, [&](size_t begin, size_t len) { return kernels.absSum(a + begin, len); },
+			   [&](size_t i) { return std::fabs(a[i]); });
+}
+
+double VectorSummation::squareSum(const double* a, size_t n) {
+	auto& kernels = VectorKernels::active();
+	return sum(n, [&](size_t begin, size_t len) { return kernels.squareSum(a + begin, len); },
+			   [&](size_t i) { return a[i] * a[i]; });
+}
+
+RC IVector::setSummation(SUMMATION mode) {
+	if (mode != SUMMATION::PAIRWISE && mode != SUMMATION::COMPENSATED) {
+		log_warning_in(getLogger(), RC::INVALID_ARGUMENT);
+		return RC::INVALID_ARGUMENT;
+	}
+
+	VectorSummation::setMode(mode);
+	return RC::SUCCESS;
+}
+
+IVector::SUMMATION IVector::getSummation() { return VectorSummation::getMode(); }
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include <IVector.h>
+
+/*
+ * Accumulation of sums behind dot and norms, selected by IVector::setSummation
+ *
+ * PAIRWISE sums blocks of BLOCK_SIZE terms with vectorized kernels and adds block sums as a balanced tree,
+ * so rounding error grows with log of dimension instead of dimension. COMPENSATED adds terms one by one
+ * with Neumaier correction, error practically doesn't depend on dimension
+ */
+namespace VectorSummation {
+
+	using Mode = IVector::SUMMATION;
+
+	Mode getMode();
+	void setMode(Mode mode);
+
+	const size_t BLOCK_SIZE = 256;
+
+	class Accumulator {
+	public:
+		void add(double term) {
+			double sum = m_sum + term;
+			if (std::fabs(m_sum) >= std::fabs(term)) {
+				m_compensation += (m_sum - sum) + term;
+			} else {
+				m_compensation += (term - sum) + m_sum;
+			}
+			m_sum = sum;
+		}
+
+		// Correction of overflowed sum is NaN, infinity is kept as is
+		double result() const { return std::isfinite(m_sum) ? m_sum + m_compensation : m_sum; }
+
+	private:
+		double m_sum = 0;
+		double m_compensation = 0;
+	};
+
+	/*
+	 * Pairwise sum of terms coming one by one, when their count isn't known in advance. Terms are added
+	 * in blocks of BLOCK_SIZE and block sums are merged like carries of a binary counter, so the tree
+	 * depth is log of the number of blocks as in pairwise
+	 */
+	class PairwiseAccumulator {
+	public:
+		void add(double term) {
+			m_block += term;
+			if (++m_blockLen < BLOCK_SIZE) {
+				return;
+			}
+
+			double sum = m_block;
+			size_t level = 0;
+			for (; (m_blockCount >> level) & 1; level++) {
+				sum = m_levels[level] + sum;
+			}
+			m_levels[level] = sum;
+			m_blockCount++;
+
+			m_block = 0;
+			m_blockLen = 0;
+		}
+
+		double result() const {
+			double res = m_block;
+			for (size_t level = 0; (m_blockCount >> level) != 0; level++) {
+				if ((m_blockCount >> level) & 1) {
+					res = m_levels[level] + res;
+				}
+			}
+			return res;
+		}
+
+	private:
+		double m_levels[64];
+		size_t m_blockCount = 0;
+		double m_block = 0;
+		size_t m_blockLen = 0;
+	};
+
+	/*
+	 * Sum of block(begin, len) over blocks of [begin, begin + n) added as a balanced tree
+	 */
+	template<class Block>
+	double pairwise(size_t begin, size_t n, Block& block) {
+		if (n <= BLOCK_SIZE) {
+			return block(begin, n);
+		}
+
+		// Split on block boundary, so every leaf but the last one is a full block
+		size_t half = (n / BLOCK_SIZE + 1) / 2 * BLOCK_SIZE;
+		return pairwise(begin, half, block) + pairwise(begin + half, n - half, block);
+	}
+
+	/*
+	 * Sum of n terms in active mode, block(begin, len) sums a range of terms, term(i) gives a single one
+	 */
+	template<class Block, class Term>
+	double sum(size_t n, Block block, Term term) {
+		if (getMode() == Mode::COMPENSATED) {
+			Accumulator acc;
+			for (size_t i = 0; i < n; i++) {
+				acc.add(term(i));
+			}
+			return acc.result();
+		}
+		return pairwise(0, n, block);
+	}
+
+	/*
+	 * Reductions of raw arrays with active kernels
+	 */
+	double dot(const double* a, const double* b, size_t n);
+	double absSum(const double* a, size_t n);
+	double squareSum(const double* a, size_t n);
+
+} // namespace VectorSummation
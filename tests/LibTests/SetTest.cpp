@@ -6,6 +6,536 @@
 #include "Tests.h"
 #include "PrintUtils.h"
 
+namespace {
+
+	void floatSetTest() {
+		size_t dim = 3;
+		double tol = 1.0e-6;
+
+		ISet* set = ISet::createSet(IVector::PRECISION::FLOAT);
+		std::vector<double> coords = { 0.1, 0.2, 0.3 };
+
+		IVector* vec = IVector::createVector(dim, coords.data());
+		assert(set->insert(vec, IVector::NORM::SECOND, tol) == RC::SUCCESS);
+		assert(set->insert(vec, IVector::NORM::SECOND, tol) == RC::VECTOR_ALREADY_EXIST);
+
+		coords[0] = 1.0e39;
+		IVector* huge = IVector::createVector(dim, coords.data());
+		assert(set->insert(huge, IVector::NORM::SECOND, tol) == RC::INFINITY_OVERFLOW);
+		delete huge;
+
+		IVector* copy;
+		assert(set->getCopy(0, copy) == RC::SUCCESS);
+		assert(copy->getPrecision() == IVector::PRECISION::FLOAT);
+		assert(copy->getFloatData()[1] == 0.2f);
+		assert(IVector::equals(copy, vec, IVector::NORM::CHEBYSHEV, tol));
+
+		assert(set->getCoords(0, vec) == RC::SUCCESS);
+		assert(vec->getData()[2] == double(0.3f));
+
+		ISet* clone = set->clone();
+		assert(clone->findFirst(copy, IVector::NORM::FIRST, tol) == RC::SUCCESS);
+		assert(clone->remove(copy, IVector::NORM::FIRST, tol) == RC::SUCCESS);
+		assert(clone->getSize() == 0 && set->getSize() == 1);
+
+		// Float vectors have no double coordinates, double sets convert them on insert and lookup
+		ISet* doubleSet = ISet::createSet();
+		assert(doubleSet->setIndex(ISet::INDEX::KD_TREE) == RC::SUCCESS);
+		assert(doubleSet->insert(copy, IVector::NORM::SECOND, tol) == RC::SUCCESS);
+		assert(doubleSet->findFirst(vec, IVector::NORM::SECOND, tol) == RC::SUCCESS);
+		assert(doubleSet->findFirst(copy, IVector::NORM::SECOND, tol) == RC::SUCCESS);
+
+		IVector* coords3 = IVector::createVector(dim, coords.data());
+		ISet::IIterator* it = set->getBegin();
+		assert(it && it->getVectorCoords(coords3) == RC::SUCCESS && coords3->getData()[1] == double(0.2f));
+
+		delete it;
+		delete coords3;
+		delete doubleSet;
+		delete clone;
+		delete copy;
+		delete vec;
+		delete set;
+	}
+
+	/*
+	 * Set with index must behave exactly as a linear scan over the same vectors
+	 */
+	void indexTest(ISet::INDEX index, size_t dim, size_t count) {
+		std::default_random_engine eng(7);
+		std::uniform_real_distribution<double> distr(-1, 1);
+
+		double tol = 1.0e-2;
+		std::vector<IVector::NORM> norms = { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV };
+
+		ISet* indexed = ISet::createSet();
+		ISet* plain = ISet::createSet();
+		assert(indexed->setIndex(index) == RC::SUCCESS);
+		assert(indexed->getIndex() == index && plain->getIndex() == ISet::INDEX::NONE);
+
+		std::vector<IVector*> vectors;
+		std::vector<double> coords(dim);
+		for (size_t i = 0; i < count; i++) {
+			for (auto& coord : coords) {
+				coord = distr(eng);
+			}
+			// Every fourth vector is a near duplicate of a previous one
+			if (i % 4 == 3) {
+				coords.assign(vectors[i / 2]->getData(), vectors[i / 2]->getData() + dim);
+				coords[0] += tol / 4;
+			}
+			vectors.push_back(IVector::createVector(dim, coords.data()));
+
+			IVector::NORM n = norms[i % norms.size()];
+			RC rc = indexed->insert(vectors.back(), n, tol);
+			assert(rc == plain->insert(vectors.back(), n, tol));
+		}
+		assert(indexed->getSize() == plain->getSize());
+
+		auto checkSame = [&](double queryTol) {
+			for (auto vec : vectors) {
+				for (auto n : norms) {
+					IVector* found1 = nullptr;
+					IVector* found2 = nullptr;
+					RC rc = indexed->findFirstAndCopy(vec, n, queryTol, found1);
+					assert(rc == plain->findFirstAndCopy(vec, n, queryTol, found2));
+					assert(!found1 || IVector::equals(found1, found2, IVector::NORM::CHEBYSHEV, 1.0e-12));
+					delete found1;
+					delete found2;
+				}
+			}
+		};
+
+		checkSame(tol);
+
+		// Another tol rebuilds the index
+		checkSame(tol * 30);
+		checkSame(tol / 100);
+
+		for (size_t i = 0; i < count; i += 3) {
+			assert(indexed->remove(vectors[i], IVector::NORM::SECOND, tol) ==
+				   plain->remove(vectors[i], IVector::NORM::SECOND, tol));
+		}
+		assert(indexed->remove(0) == plain->remove(0));
+		assert(indexed->getSize() == plain->getSize());
+		checkSame(tol);
+
+		ISet* clone = indexed->clone();
+		assert(clone->getIndex() == index);
+		assert(ISet::equals(clone, plain, IVector::NORM::CHEBYSHEV, tol));
+		delete clone;
+
+		for (auto vec : vectors) {
+			delete vec;
+		}
+		delete indexed;
+		delete plain;
+	}
+
+	void hashGridTest() {
+		ISet* set = ISet::createSet();
+		assert(set->setIndex(ISet::INDEX::AMOUNT) == RC::INVALID_ARGUMENT);
+		assert(set->setIndex(ISet::INDEX::HASH_GRID) == RC::SUCCESS);
+
+		// Patterns far from origin relative to tol are searched without the grid
+		double tol = 1.0e-6;
+		IVector* vec = IVector::createVector(2, std::vector<double>{ 3.0e30, 1 }.data());
+		assert(set->insert(vec, IVector::NORM::SECOND, tol) == RC::SUCCESS);
+		assert(set->findFirst(vec, IVector::NORM::SECOND, tol) == RC::SUCCESS);
+		assert(set->findFirst(vec, IVector::NORM::SECOND, 1.0e30) == RC::SUCCESS);
+		delete vec;
+
+		// Dimension changes once the set gets empty
+		assert(set->remove(0) == RC::SUCCESS);
+		vec = IVector::createVector(1, std::vector<double>{ 0.5 }.data());
+		assert(set->insert(vec, IVector::NORM::FIRST, tol) == RC::SUCCESS);
+		assert(set->insert(vec, IVector::NORM::FIRST, tol) == RC::VECTOR_ALREADY_EXIST);
+		delete vec;
+		delete set;
+
+		// Float rows are bucketed by their rounded coordinates
+		set = ISet::createSet(IVector::PRECISION::FLOAT);
+		set->setIndex(ISet::INDEX::HASH_GRID);
+		vec = IVector::createVector(2, std::vector<double>{ 0.1, -0.7 }.data());
+		assert(set->insert(vec, IVector::NORM::CHEBYSHEV, tol) == RC::SUCCESS);
+		assert(set->findFirst(vec, IVector::NORM::CHEBYSHEV, tol) == RC::SUCCESS);
+		assert(set->remove(vec, IVector::NORM::CHEBYSHEV, tol) == RC::SUCCESS);
+		assert(set->findFirst(vec, IVector::NORM::CHEBYSHEV, tol) == RC::VECTOR_NOT_FOUND);
+		delete vec;
+		delete set;
+
+		indexTest(ISet::INDEX::HASH_GRID, 2, 400);
+		indexTest(ISet::INDEX::HASH_GRID, 6, 400);
+	}
+
+	void kdTreeTest() {
+		size_t dim = 8;
+		size_t count = 3000;
+		double tol = 1.0e-3;
+		auto n = IVector::NORM::SECOND;
+
+		ISet* set = ISet::createSet(IVector::PRECISION::FLOAT);
+		assert(set->setIndex(ISet::INDEX::KD_TREE) == RC::SUCCESS);
+
+		// Sorted vectors on a line make every insert go down the same path until it is rebalanced
+		std::vector<IVector*> vectors;
+		for (size_t i = 0; i < count; i++) {
+			vectors.push_back(IVector::createVector(dim, std::vector<double>(dim, i * 0.01).data()));
+			assert(set->insert(vectors.back(), n, tol) == RC::SUCCESS);
+		}
+
+		IVector* shifted = IVector::createVector(dim, std::vector<double>(dim).data());
+		for (size_t i = 0; i < count; i++) {
+			assert(set->findFirst(vectors[i], n, tol) == RC::SUCCESS);
+
+			shifted->setData(dim, vectors[i]->getData());
+			shifted->setCoord(i % dim, i * 0.01 + 0.005);
+			assert(set->findFirst(shifted, n, tol) == RC::VECTOR_NOT_FOUND);
+		}
+		delete shifted;
+
+		// Removing most of the vectors rebuilds the tree without them
+		for (size_t i = 0; i < count; i++) {
+			if (i % 3 != 0) {
+				assert(set->remove(vectors[i], n, tol) == RC::SUCCESS);
+			}
+		}
+		assert(set->getSize() == count / 3);
+
+		for (size_t i = 0; i < count; i++) {
+			RC rc = set->findFirst(vectors[i], n, tol);
+			assert(rc == (i % 3 == 0 ? RC::SUCCESS : RC::VECTOR_NOT_FOUND));
+		}
+
+		for (auto vec : vectors) {
+			delete vec;
+		}
+		delete set;
+
+		indexTest(ISet::INDEX::KD_TREE, 2, 400);
+		indexTest(ISet::INDEX::KD_TREE, 16, 400);
+	}
+
+	/*
+	 * Block insert must give the same statuses and order as inserting vectors one by one
+	 */
+	void insertManyTest(ISet::INDEX index, IVector::PRECISION precision) {
+		std::default_random_engine eng(11);
+		std::uniform_real_distribution<double> distr(-1, 1);
+
+		size_t dim = 3;
+		size_t count = 500;
+		double tol = 0.05;
+		auto n = IVector::NORM::SECOND;
+
+		std::vector<double> coords(count * dim);
+		for (auto& coord : coords) {
+			coord = distr(eng);
+		}
+		// Near duplicates of earlier vectors of the block
+		for (size_t i = 5; i < count; i += 5) {
+			std::copy(coords.begin() + (i / 3) * dim, coords.begin() + (i / 3 + 1) * dim, coords.begin() + i * dim);
+			coords[i * dim + 1] += tol / 3;
+		}
+		coords[7 * dim + 2] = NAN;
+
+		ISet* sequential = ISet::createSet(precision);
+		ISet* block = ISet::createSet(precision);
+		assert(block->setIndex(index) == RC::SUCCESS);
+
+		// Part of the vectors is already in the sets
+		size_t inserted = 100;
+		for (size_t i = 0; i < inserted; i++) {
+			IVector* vec = IVector::createVector(dim, coords.data() + i * dim);
+			if (vec) {
+				RC rc = sequential->insert(vec, n, tol);
+				assert(rc == block->insert(vec, n, tol));
+			}
+			delete vec;
+		}
+
+		std::vector<RC> statuses(count);
+		assert(block->insertMany(count, dim, coords.data(), n, tol, statuses.data()) == RC::NOT_NUMBER);
+		assert(statuses[7] == RC::NOT_NUMBER);
+
+		for (size_t i = 0; i < count; i++) {
+			IVector* vec = IVector::createVector(dim, coords.data() + i * dim);
+			if (!vec) {
+				continue;
+			}
+			assert(sequential->insert(vec, n, tol) == statuses[i]);
+			delete vec;
+		}
+		assert(statuses[0] == RC::VECTOR_ALREADY_EXIST && statuses[inserted + 1] == RC::SUCCESS);
+		assert(statuses[inserted + 5] == RC::VECTOR_ALREADY_EXIST);
+
+		assert(block->getSize() == sequential->getSize());
+		IVector* vec1 = IVector::createVector(dim, coords.data());
+		IVector* vec2 = IVector::createVector(dim, coords.data());
+		for (size_t i = 0; i < block->getSize(); i++) {
+			block->getCoords(i, vec1);
+			sequential->getCoords(i, vec2);
+			assert(IVector::equals(vec1, vec2, IVector::NORM::CHEBYSHEV, 1.0e-12));
+		}
+		delete vec1;
+		delete vec2;
+
+		assert(block->insertMany(1, dim + 1, coords.data(), n, tol) == RC::MISMATCHING_DIMENSIONS);
+		assert(block->insertMany(1, dim, nullptr, n, tol) == RC::NULLPTR_ERROR);
+		assert(block->insertMany(0, dim, nullptr, n, tol) == RC::SUCCESS);
+
+		delete sequential;
+		delete block;
+	}
+
+	/*
+	 * Linear scan compares stored rows in place without creating vectors
+	 */
+	void scanTest() {
+		size_t dim = 16;
+		size_t count = 1000;
+		double tol = 1.0e-6;
+
+		for (auto precision : { IVector::PRECISION::DOUBLE, IVector::PRECISION::FLOAT }) {
+			ISet* set = ISet::createSet(precision);
+			std::vector<double> coords(dim);
+			for (size_t i = 0; i < count; i++) {
+				coords[i % dim] = static_cast<double>(i);
+				IVector* vec = IVector::createVector(dim, coords.data());
+				assert(set->insert(vec, IVector::NORM::FIRST, tol) == RC::SUCCESS);
+				delete vec;
+			}
+
+			IVector* missing = IVector::createVector(dim, std::vector<double>(dim, -1).data());
+			IVector* last = IVector::createVector(dim, coords.data());
+
+			// Warms up buffers reused by lookups
+			assert(set->findFirst(missing, IVector::NORM::SECOND, tol) == RC::VECTOR_NOT_FOUND);
+
+			if (IVector::setCountersEnabled(true) == RC::SUCCESS) {
+				IVector::resetOperationCounters();
+
+				for (auto n : { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV }) {
+					assert(set->findFirst(missing, n, tol) == RC::VECTOR_NOT_FOUND);
+					assert(set->findFirst(last, n, tol) == RC::SUCCESS);
+				}
+
+				IVector::OperationCounters counters = IVector::getOperationCounters();
+				assert(counters.allocations == 0);
+				assert(counters.calls[static_cast<size_t>(IVector::OPERATION::CREATE)] == 0);
+				assert(counters.calls[static_cast<size_t>(IVector::OPERATION::EQUALS)] == 3 * 2 * count);
+
+				IVector::setCountersEnabled(false);
+				IVector::resetOperationCounters();
+			}
+
+			delete missing;
+			delete last;
+			delete set;
+		}
+	}
+
+	/*
+	 * Removed rows wait for compaction, indices and iterators must not see them
+	 */
+	void tombstoneTest(ISet::INDEX index, double ratio) {
+		size_t dim = 3;
+		size_t count = 200;
+		double tol = 1.0e-2;
+		auto n = IVector::NORM::CHEBYSHEV;
+
+		ISet* set = ISet::createSet();
+		assert(set->getGarbageRatio() == 0.5);
+		assert(set->setGarbageRatio(1) == RC::INVALID_ARGUMENT);
+		assert(set->setGarbageRatio(-0.1) == RC::INVALID_ARGUMENT);
+		assert(set->setGarbageRatio(ratio) == RC::SUCCESS && set->getGarbageRatio() == ratio);
+		assert(set->setIndex(index) == RC::SUCCESS);
+
+		std::vector<double> coords(dim);
+		for (size_t i = 0; i < count; i++) {
+			coords[0] = static_cast<double>(i);
+			IVector* vec = IVector::createVector(dim, coords.data());
+			assert(set->insert(vec, n, tol) == RC::SUCCESS);
+			delete vec;
+		}
+
+		IVector* vec = IVector::createVector(dim, coords.data());
+		ISet::IIterator* it = set->getIterator(1);
+
+		// Every removal by index drops the next odd vector
+		for (size_t i = 1; i < set->getSize(); i++) {
+			assert(set->remove(i) == RC::SUCCESS);
+		}
+		assert(set->getSize() == count / 2);
+
+		for (size_t i = 0; i < count; i++) {
+			vec->setCoord(0, static_cast<double>(i));
+			assert((set->findFirst(vec, n, tol) == RC::SUCCESS) == (i % 2 == 0));
+		}
+
+		ISet* clone = set->clone();
+		for (auto current : { set, clone }) {
+			for (size_t i = 0; i < count / 2; i++) {
+				assert(current->getCoords(i, vec) == RC::SUCCESS && vec->getData()[0] == 2.0 * i);
+			}
+			assert(current->getCoords(count / 2, vec) == RC::INDEX_OUT_OF_BOUND);
+		}
+
+		// Iterator of removed vector moves to neighbours of its place
+		assert(it->next() == RC::SUCCESS);
+		assert(it->getVectorCoords(vec) == RC::SUCCESS && vec->getData()[0] == 2);
+		assert(it->previous() == RC::SUCCESS);
+		assert(it->getVectorCoords(vec) == RC::SUCCESS && vec->getData()[0] == 0);
+		assert(it->previous() != RC::SUCCESS);
+		delete it;
+
+		it = set->getEnd();
+		assert(it->getVectorCoords(vec) == RC::SUCCESS && vec->getData()[0] == count - 2);
+		delete it;
+
+		// New vectors go after the live ones
+		vec->setCoord(0, 1);
+		assert(set->insert(vec, n, tol) == RC::SUCCESS);
+		assert(set->getCoords(count / 2, vec) == RC::SUCCESS && vec->getData()[0] == 1);
+
+		while (set->getSize() != 0) {
+			assert(set->remove(set->getSize() / 2) == RC::SUCCESS);
+		}
+		assert(set->findFirst(vec, n, tol) == RC::VECTOR_NOT_FOUND);
+		assert(set->insert(vec, n, tol) == RC::SUCCESS && set->getSize() == 1);
+
+		delete clone;
+		delete vec;
+		delete set;
+	}
+
+	/*
+	 * Operands large enough to be searched through an index
+	 */
+	void algebraTest(ISet::INDEX index) {
+		std::default_random_engine eng(13);
+		std::uniform_real_distribution<double> distr(-1, 1);
+
+		size_t dim = 4;
+		size_t count = 300;
+		size_t shared = 200;
+		double tol = 1.0e-2;
+		auto n = IVector::NORM::SECOND;
+
+		std::vector<double> coords1(count * dim);
+		std::vector<double> coords2(count * dim);
+		for (size_t i = 0; i < count * dim; i++) {
+			coords1[i] = distr(eng);
+			// The first shared vectors of op2 are shifted ones of op1, the rest are new
+			coords2[i] = i < shared * dim ? coords1[i] + tol / 4 : distr(eng);
+		}
+
+		ISet* op1 = ISet::createSet();
+		ISet* op2 = ISet::createSet();
+		assert(op1->setIndex(index) == RC::SUCCESS);
+		assert(op1->insertMany(count, dim, coords1.data(), n, tol) == RC::SUCCESS);
+		assert(op2->insertMany(count, dim, coords2.data(), n, tol) == RC::SUCCESS);
+
+		auto containsAll = [&](ISet* set, ISet* other, bool isExpected) {
+			IVector* vec = IVector::createVector(dim, coords1.data());
+			for (size_t i = 0; i < set->getSize(); i++) {
+				assert(set->getCoords(i, vec) == RC::SUCCESS);
+				assert((other->findFirst(vec, n, tol) == RC::SUCCESS) == isExpected);
+			}
+			delete vec;
+		};
+
+		ISet* intersection = ISet::makeIntersection(op1, op2, n, tol);
+		assert(intersection->getSize() == shared);
+		containsAll(intersection, op1, true);
+		containsAll(intersection, op2, true);
+
+		ISet* unionSet = ISet::makeUnion(op1, op2, n, tol);
+		assert(unionSet->getSize() == 2 * count - shared && unionSet->getIndex() == index);
+
+		ISet* sub = ISet::sub(op1, op2, n, tol);
+		assert(sub->getSize() == count - shared);
+		containsAll(sub, op2, false);
+
+		ISet* symSub = ISet::symSub(op1, op2, n, tol);
+		assert(symSub->getSize() == 2 * (count - shared));
+		containsAll(symSub, intersection, false);
+		containsAll(symSub, unionSet, true);
+
+		ISet* clone = op1->clone();
+		assert(ISet::equals(op1, clone, n, tol) && !ISet::equals(op1, op2, n, tol));
+		assert(ISet::equals(op1, op2, n, tol * 1000));
+		assert(ISet::subSet(intersection, op1, n, tol) && ISet::subSet(op1, unionSet, n, tol));
+		assert(!ISet::subSet(unionSet, op1, n, tol));
+
+		// Empty operand and operand of another dimension
+		ISet* empty = ISet::createSet();
+		ISet* other = ISet::createSet();
+		assert(other->insertMany(1, dim + 1, coords1.data(), n, tol) == RC::SUCCESS);
+
+		ISet* result = ISet::makeUnion(op1, empty, n, tol);
+		assert(result->getSize() == count);
+		delete result;
+		result = ISet::symSub(empty, op1, n, tol);
+		assert(result->getSize() == count);
+		delete result;
+		result = ISet::makeIntersection(op1, other, n, tol);
+		assert(result->getSize() == 0);
+		delete result;
+
+		assert(ISet::makeUnion(op1, other, n, tol) == nullptr);
+		assert(ISet::sub(nullptr, op1, n, tol) == nullptr);
+		assert(ISet::subSet(empty, op1, n, tol) && !ISet::subSet(op1, empty, n, tol));
+		assert(!ISet::equals(op1, other, n, tol) && !ISet::equals(op1, nullptr, n, tol));
+
+		/*
+		 * Multiplicity: vectors inserted with a smaller tol, 0 and 0.9 are both within tol of 0.5, so one
+		 * vector of op2 removes both of them whatever their order, and 5 is kept
+		 */
+		const double close[] = { 0.0, 0.9, 5.0 };
+		const double reversed[] = { 5.0, 0.9, 0.0 };
+		const double middle[] = { 0.5 };
+		ISet* closeSet = ISet::createSet();
+		ISet* reversedSet = ISet::createSet();
+		ISet* middleSet = ISet::createSet();
+		assert(closeSet->setIndex(index) == RC::SUCCESS && reversedSet->setIndex(index) == RC::SUCCESS);
+		assert(closeSet->insertMany(3, 1, close, IVector::NORM::FIRST, 0.1) == RC::SUCCESS);
+		assert(reversedSet->insertMany(3, 1, reversed, IVector::NORM::FIRST, 0.1) == RC::SUCCESS);
+		assert(middleSet->insertMany(1, 1, middle, IVector::NORM::FIRST, 0.1) == RC::SUCCESS);
+
+		IVector* kept = IVector::createVector(1, close);
+		double value = 0;
+		for (ISet* set : { closeSet, reversedSet }) {
+			result = ISet::sub(set, middleSet, IVector::NORM::FIRST, 1.0);
+			assert(result->getSize() == 1);
+			assert(result->getCoords(0, kept) == RC::SUCCESS && kept->getCoord(0, value) == RC::SUCCESS);
+			assert(value == 5.0);
+			delete result;
+
+			result = ISet::symSub(set, middleSet, IVector::NORM::FIRST, 1.0);
+			assert(result->getSize() == 1);
+			assert(result->getCoords(0, kept) == RC::SUCCESS && kept->getCoord(0, value) == RC::SUCCESS);
+			assert(value == 5.0);
+			delete result;
+		}
+		delete kept;
+
+		delete closeSet;
+		delete reversedSet;
+		delete middleSet;
+		delete empty;
+		delete other;
+		delete clone;
+		delete intersection;
+		delete unionSet;
+		delete sub;
+		delete symSub;
+		delete op1;
+		delete op2;
+	}
+
+} // namespace
+
 void Tests::setTest(ILogger* logger) {
 	ISet::setLogger(logger);
 	ISet::IIterator::setLogger(logger);
@@ -88,5 +618,22 @@ void Tests::setTest(ILogger* logger) {
 	delete set1;
 	delete set2;
 
+	floatSetTest();
+	hashGridTest();
+	kdTreeTest();
+	scanTest();
+
+	for (auto index : { ISet::INDEX::NONE, ISet::INDEX::HASH_GRID, ISet::INDEX::KD_TREE }) {
+		for (double ratio : { 0.0, 0.5, 0.9 }) {
+			tombstoneTest(index, ratio);
+		}
+		algebraTest(index);
+	}
+
+	for (auto index : { ISet::INDEX::NONE, ISet::INDEX::HASH_GRID, ISet::INDEX::KD_TREE }) {
+		insertManyTest(index, IVector::PRECISION::DOUBLE);
+		insertManyTest(index, IVector::PRECISION::FLOAT);
+	}
+
 	std::cout << "Set test successfully finished\n\n";
 }
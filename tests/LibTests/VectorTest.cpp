@@ -1,11 +1,999 @@
 #include <vector>
+#include <atomic>
 #include <iostream>
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
 #include <limits>
+#include <random>
+#include <thread>
 
 #include "Tests.h"
+#include "IVectorFile.h"
+#include "VectorExpression.h"
 #include "PrintUtils.h"
 
+namespace {
+
+	bool relativeCompare(double x, double ref, double tol) {
+		return fabs(x - ref) <= tol * std::max(1.0, fabs(ref));
+	}
+
+	/*
+	 * Runs reductions, inc/dec and comparisons with every supported instruction set and compares them
+	 * against the scalar reference kernels
+	 */
+	void instructionSetsTest() {
+		using InstructionSet = IVector::INSTRUCTION_SET;
+
+		std::default_random_engine eng(42);
+		std::uniform_real_distribution<double> distr(-100, 100);
+
+		double tol = 1.0e-10;
+		InstructionSet initialSet = IVector::getInstructionSet();
+		std::cout << "Detected instruction set: " << int(initialSet) << std::endl;
+
+		for (size_t dim : { 1, 3, 7, 16, 33, 1000, 4099 }) {
+			std::vector<double> data1(dim), data2(dim);
+			for (size_t i = 0; i < dim; i++) {
+				data1[i] = distr(eng);
+				data2[i] = distr(eng);
+			}
+
+			IVector* vec1 = IVector::createVector(dim, data1.data());
+			IVector* vec2 = IVector::createVector(dim, data2.data());
+
+			assert(IVector::setInstructionSet(InstructionSet::SCALAR) == RC::SUCCESS);
+			double refDot = IVector::dot(vec1, vec2);
+			double refFirst = vec1->norm(IVector::NORM::FIRST);
+			double refSecond = vec1->norm(IVector::NORM::SECOND);
+			double refChebyshev = vec1->norm(IVector::NORM::CHEBYSHEV);
+
+			IVector* diff = IVector::sub(vec1, vec2);
+			double refDists[] = { diff->norm(IVector::NORM::FIRST), diff->norm(IVector::NORM::SECOND),
+								  diff->norm(IVector::NORM::CHEBYSHEV) };
+			IVector::NORM norms[] = { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV };
+			delete diff;
+
+			// Single mismatch in the last coordinate, so early exit can't hide it
+			std::vector<double> nearData = data1;
+			nearData[dim - 1] += 1.0;
+			IVector* nearVec = IVector::createVector(dim, nearData.data());
+
+			for (int set = int(InstructionSet::SCALAR); set < int(InstructionSet::AMOUNT); set++) {
+				if (!IVector::isInstructionSetSupported(InstructionSet(set))) {
+					assert(IVector::setInstructionSet(InstructionSet(set)) != RC::SUCCESS);
+					continue;
+				}
+				assert(IVector::setInstructionSet(InstructionSet(set)) == RC::SUCCESS);
+
+				assert(relativeCompare(IVector::dot(vec1, vec2), refDot, tol));
+				assert(relativeCompare(vec1->norm(IVector::NORM::FIRST), refFirst, tol));
+				assert(relativeCompare(vec1->norm(IVector::NORM::SECOND), refSecond, tol));
+				assert(vec1->norm(IVector::NORM::CHEBYSHEV) == refChebyshev);
+
+				for (size_t i = 0; i < 3; i++) {
+					assert(IVector::equals(vec1, vec2, norms[i], refDists[i] * (1 + tol)));
+					assert(!IVector::equals(vec1, vec2, norms[i], refDists[i] * (1 - tol)));
+					assert(IVector::equals(vec1, vec1, norms[i], tol));
+					assert(IVector::equals(vec1, nearVec, norms[i], 1.5));
+					assert(!IVector::equals(vec1, nearVec, norms[i], 0.5));
+				}
+
+				// NaN of a view is never equal and gives NaN norms, whether it is in a block or in the tail
+				for (size_t pos : { size_t(0), dim - 1 }) {
+					std::vector<double> nanData = data1;
+					nanData[pos] = std::numeric_limits<double>::quiet_NaN();
+					IVector* nanView = IVector::createView(dim, nanData.data());
+					for (size_t i = 0; i < 3; i++) {
+						assert(!IVector::equals(vec1, nanView, norms[i], 1.0e300));
+						assert(!IVector::equals(data1.data(), nanData.data(), dim, norms[i], 1.0e300));
+						assert(std::isnan(nanView->norm(norms[i])));
+					}
+					delete nanView;
+				}
+
+				IVector* incRes = vec1->clone();
+				assert(incRes->inc(vec2) == RC::SUCCESS);
+				IVector* decRes = vec1->clone();
+				assert(decRes->dec(vec2) == RC::SUCCESS);
+
+				for (size_t i = 0; i < dim; i++) {
+					assert(incRes->getData()[i] == data1[i] + data2[i]);
+					assert(decRes->getData()[i] == data1[i] - data2[i]);
+				}
+
+				IVector* axpyRes = vec1->clone();
+				assert(axpyRes->axpy(-0.5, vec2) == RC::SUCCESS);
+				IVector* axpbyRes = vec1->clone();
+				assert(axpbyRes->axpby(2.0, vec2, 0.25) == RC::SUCCESS);
+
+				// Result aliases the first operand
+				IVector* combRes = vec1->clone();
+				const IVector* ops[] = { combRes, vec2, vec1 };
+				const double coeffs[] = { 1.0, 3.0, -0.5 };
+				assert(combRes->linearCombination(3, coeffs, ops) == RC::SUCCESS);
+
+				for (size_t i = 0; i < dim; i++) {
+					assert(relativeCompare(axpyRes->getData()[i], data1[i] - 0.5 * data2[i], tol));
+					assert(relativeCompare(axpbyRes->getData()[i], 2.0 * data2[i] + 0.25 * data1[i], tol));
+					assert(relativeCompare(combRes->getData()[i], 0.5 * data1[i] + 3.0 * data2[i], tol));
+				}
+
+				delete incRes;
+				delete decRes;
+				delete axpyRes;
+				delete axpbyRes;
+				delete combRes;
+			}
+
+			std::vector<double> hugeData(dim, std::numeric_limits<double>::max());
+			IVector* huge = IVector::createVector(dim, hugeData.data());
+			assert(huge->inc(huge) == RC::INFINITY_OVERFLOW);
+			delete huge;
+
+			// Square of such tol underflows to zero
+			std::vector<double> tinyData(dim);
+			tinyData[dim - 1] = 3.0e-170;
+			IVector* tiny = IVector::createVector(dim, tinyData.data());
+			IVector* zero = IVector::createVector(dim, std::vector<double>(dim).data());
+			assert(IVector::equals(vec1, vec1, IVector::NORM::SECOND, 1.0e-170));
+			assert(IVector::equals(tiny, zero, IVector::NORM::SECOND, 4.0e-170));
+			assert(!IVector::equals(tiny, zero, IVector::NORM::SECOND, 2.0e-170));
+			assert(!IVector::equals(tinyData.data(), zero->getData(), dim, IVector::NORM::SECOND, 2.0e-170));
+			delete tiny;
+			delete zero;
+
+			delete nearVec;
+			delete vec1;
+			delete vec2;
+		}
+
+		IVector::setInstructionSet(initialSet);
+		std::cout << "All instruction sets match scalar kernels" << std::endl;
+	}
+
+	void alignmentTest() {
+		for (size_t dim : { 1, 2, 5, 64, 1000, 300000 }) {
+			std::vector<double> data(dim, 2.0);
+			IVector* vec = IVector::createVector(dim, data.data());
+			IVector* copy = vec->clone();
+
+			assert(reinterpret_cast<uintptr_t>(vec->getData()) % 64 == 0);
+			assert(reinterpret_cast<uintptr_t>(copy->getData()) % 64 == 0);
+			assert(vec->sizeAllocated() >= dim * sizeof(double) + sizeof(IVector));
+
+			assert(vec->scale(0.5) == RC::SUCCESS);
+			assert(IVector::copyInstance(copy, vec) == RC::SUCCESS);
+			assert(IVector::copyInstance(copy, copy) == RC::MEMORY_INTERSECTION);
+			assert(copy->getData()[dim - 1] == 1.0);
+
+			delete vec;
+			delete copy;
+		}
+	}
+
+	void viewTest() {
+		size_t dim = 5;
+		double tol = 1.0e-10;
+		std::vector<double> buffer = { 1, 2, 3, 4, 5 };
+
+		IVector* view = IVector::createView(dim, buffer.data());
+		assert(view->getData() == buffer.data());
+
+		assert(view->scale(2) == RC::SUCCESS);
+		assert(buffer[4] == 10);
+
+		buffer[0] = -1;
+		double coord;
+		view->getCoord(0, coord);
+		assert(coord == -1);
+
+		IVector* copy = view->clone();
+		assert(copy->getData() != buffer.data());
+		assert(IVector::equals(copy, view, IVector::NORM::CHEBYSHEV, tol));
+
+		assert(copy->inc(view) == RC::SUCCESS);
+		assert(IVector::copyInstance(view, copy) == RC::SUCCESS);
+		assert(buffer[1] == 8);
+
+		delete view;
+		assert(buffer[2] == 12);
+
+		delete copy;
+	}
+
+	/*
+	 * Small dimensions get unrolled vectors, views always use generic code, so both must agree
+	 */
+	void fixedDimensionTest() {
+		double tol = 1.0e-12;
+
+		for (size_t dim : { 2, 3, 4, 8 }) {
+			std::vector<double> data1(dim), data2(dim);
+			for (size_t i = 0; i < dim; i++) {
+				data1[i] = 1.5 * i - 2;
+				data2[i] = 3.0 - i;
+			}
+			std::vector<double> viewData = data1;
+
+			IVector* fixed = IVector::createVector(dim, data1.data());
+			IVector* generic = IVector::createView(dim, viewData.data());
+			IVector* op = IVector::createVector(dim, data2.data());
+
+			assert(reinterpret_cast<uintptr_t>(fixed->getData()) % 64 == 0);
+
+			assert(fixed->inc(op) == RC::SUCCESS && generic->inc(op) == RC::SUCCESS);
+			assert(fixed->axpy(0.5, op) == RC::SUCCESS && generic->axpy(0.5, op) == RC::SUCCESS);
+			assert(fixed->axpby(-1.5, op, 2.0) == RC::SUCCESS && generic->axpby(-1.5, op, 2.0) == RC::SUCCESS);
+			assert(fixed->dec(op) == RC::SUCCESS && generic->dec(op) == RC::SUCCESS);
+			assert(fixed->scale(3.0) == RC::SUCCESS && generic->scale(3.0) == RC::SUCCESS);
+
+			const IVector* fixedOps[] = { fixed, op };
+			const IVector* genericOps[] = { generic, op };
+			const double coeffs[] = { 0.5, -2.0 };
+			assert(fixed->linearCombination(2, coeffs, fixedOps) == RC::SUCCESS);
+			assert(generic->linearCombination(2, coeffs, genericOps) == RC::SUCCESS);
+
+			assert(IVector::equals(fixed, generic, IVector::NORM::CHEBYSHEV, tol));
+			for (auto n : { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV }) {
+				assert(relativeCompare(fixed->norm(n), generic->norm(n), tol));
+			}
+
+			IVector* wrongDim = IVector::createVector(dim + 1, std::vector<double>(dim + 1).data());
+			assert(fixed->inc(wrongDim) == RC::MISMATCHING_DIMENSIONS);
+			delete wrongDim;
+
+			RC rc = fixed->scale(std::numeric_limits<double>::max());
+			rc = rc == RC::SUCCESS ? fixed->scale(std::numeric_limits<double>::max()) : rc;
+			assert(rc == RC::INFINITY_OVERFLOW);
+
+			delete fixed;
+			delete generic;
+			delete op;
+		}
+	}
+
+	void blockFunctionTest() {
+		size_t dim = 3000;
+		std::vector<double> data(dim);
+		for (size_t i = 0; i < dim; i++) {
+			data[i] = double(i) - 1000;
+		}
+
+		IVector* vec = IVector::createVector(dim, data.data());
+		IVector* ref = vec->clone();
+
+		assert(vec->applyInline([](double x) { return 0.5 * x * x; }) == RC::SUCCESS);
+		assert(ref->applyFunction([](double x) { return 0.5 * x * x; }) == RC::SUCCESS);
+		assert(IVector::equals(vec, ref, IVector::NORM::CHEBYSHEV, 1.0e-12));
+
+		// Spans cover every coordinate once and in order
+		size_t visited = 0;
+		assert(vec->foreachBlock([&](const double* in, size_t n) {
+			for (size_t i = 0; i < n; i++) {
+				assert(in[i] == ref->getData()[visited + i]);
+			}
+			visited += n;
+		}) == RC::SUCCESS);
+		assert(visited == dim);
+
+		double sum = 0;
+		vec->foreachInline([&sum](double x) { sum += x; });
+		double refSum = 0;
+		ref->foreach([&refSum](double x) { refSum += x; });
+		assert(sum == refSum);
+
+		double nan = std::numeric_limits<double>::quiet_NaN();
+		assert(vec->applyBlockFunction([nan](const double*, double* out, size_t n) {
+			out[n - 1] = nan;
+		}) == RC::NOT_NUMBER);
+
+		delete vec;
+		delete ref;
+	}
+
+	/*
+	 * Failed updates leave the span with the bad result as it was, no NaN or infinity is stored
+	 */
+	void failedUpdateTest() {
+		double max = std::numeric_limits<double>::max();
+		double nan = std::numeric_limits<double>::quiet_NaN();
+
+		auto isFinite = [](const IVector* vec) {
+			bool finite = true;
+			vec->foreach([&finite](double x) { finite = finite && std::isfinite(x); });
+			return finite;
+		};
+
+		for (size_t dim : { 3, 3000 }) {
+			std::vector<double> data(dim, 1.0);
+			data[dim - 1] = max;
+			IVector* vec = IVector::createVector(dim, data.data());
+			IVector* ref = vec->clone();
+
+			const IVector* ops[] = { vec, ref };
+			const double coeffs[] = { 1.0, 1.0 };
+
+			assert(vec->scale(4.0) == RC::INFINITY_OVERFLOW);
+			assert(vec->inc(ref) == RC::INFINITY_OVERFLOW);
+			assert(vec->axpby(1.0, ref, 2.0) == RC::INFINITY_OVERFLOW);
+			assert(vec->linearCombination(2, coeffs, ops) == RC::INFINITY_OVERFLOW);
+			assert(vec->applyFunction([nan](double x) { return x > 2.0 ? nan : x; }) == RC::NOT_NUMBER);
+			assert(vec->applyInline([](double x) { return 2.0 * x; }) == RC::INFINITY_OVERFLOW);
+			assert(isFinite(vec) && vec->getData()[dim - 1] == max);
+
+			delete vec;
+			delete ref;
+		}
+
+		std::vector<double> sparseData(100, 0.0);
+		sparseData[10] = 1.0;
+		sparseData[90] = max;
+		IVector* sparse = IVector::createSparseVector(100, sparseData.data());
+		IVector* dense = IVector::createVector(100, sparseData.data());
+
+		assert(sparse->scale(4.0) == RC::INFINITY_OVERFLOW);
+		assert(dense->axpy(1.0, sparse) == RC::INFINITY_OVERFLOW);
+		assert(isFinite(sparse) && isFinite(dense));
+		assert(IVector::equals(sparse, dense, IVector::NORM::CHEBYSHEV, 1.0e-300));
+
+		delete sparse;
+		delete dense;
+	}
+
+	/*
+	 * Results of parallel operations must not depend on the number of threads
+	 */
+	void parallelTest() {
+		size_t dim = 300000;
+		std::vector<double> data1(dim), data2(dim);
+		for (size_t i = 0; i < dim; i++) {
+			data1[i] = sin(double(i));
+			data2[i] = cos(double(i)) * 1.0e3;
+		}
+
+		size_t initialThreshold = IVector::getParallelThreshold();
+		size_t initialThreads = IVector::getMaxThreads();
+		assert(IVector::setMaxThreads(0) == RC::INVALID_ARGUMENT);
+
+		IVector* vec1 = IVector::createVector(dim, data1.data());
+		IVector* vec2 = IVector::createVector(dim, data2.data());
+
+		IVector::NORM norms[] = { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV };
+		double serialNorms[3];
+		for (size_t k = 0; k < 3; k++) {
+			serialNorms[k] = vec1->norm(norms[k]);
+		}
+		double serialDot = IVector::dot(vec1, vec2);
+
+		IVector::setParallelThreshold(1000);
+
+		assert(IVector::setMaxThreads(1) == RC::SUCCESS);
+		double refDot = IVector::dot(vec1, vec2);
+		double refNorms[3];
+		for (size_t k = 0; k < 3; k++) {
+			refNorms[k] = vec1->norm(norms[k]);
+			assert(relativeCompare(refNorms[k], serialNorms[k], 1.0e-12));
+		}
+		assert(relativeCompare(refDot, serialDot, 1.0e-12));
+
+		IVector* refAxpy = vec1->clone();
+		assert(refAxpy->axpy(-0.25, vec2) == RC::SUCCESS);
+
+		// Bad coordinates in different chunks, the first one must be reported
+		std::vector<double> badData = data1;
+		badData[dim / 2] = std::numeric_limits<double>::quiet_NaN();
+		badData[dim - 1] = std::numeric_limits<double>::infinity();
+		IVector* bad = IVector::createView(dim, badData.data());
+
+		for (size_t threads : { 2, 3, 8 }) {
+			assert(IVector::setMaxThreads(threads) == RC::SUCCESS);
+
+			assert(IVector::dot(vec1, vec2) == refDot);
+			for (size_t k = 0; k < 3; k++) {
+				assert(vec1->norm(norms[k]) == refNorms[k]);
+			}
+
+			IVector* axpyRes = vec1->clone();
+			assert(axpyRes->axpy(-0.25, vec2) == RC::SUCCESS);
+			assert(IVector::equals(axpyRes, refAxpy, IVector::NORM::CHEBYSHEV, 1.0e-300));
+			assert(axpyRes->inc(vec2) == RC::SUCCESS && axpyRes->dec(vec2) == RC::SUCCESS);
+			delete axpyRes;
+
+			assert(bad->scale(1.0) == RC::NOT_NUMBER);
+		}
+
+		delete bad;
+		delete refAxpy;
+		delete vec1;
+		delete vec2;
+
+		IVector::setParallelThreshold(initialThreshold);
+		IVector::setMaxThreads(initialThreads);
+	}
+
+	void floatStorageTest() {
+		size_t dim = 1000;
+		double tol = 1.0e-12;
+
+		std::vector<double> data1(dim), data2(dim), rounded1(dim);
+		for (size_t i = 0; i < dim; i++) {
+			data1[i] = 0.1 * i - 7;
+			data2[i] = 1.0 / (i + 1);
+			rounded1[i] = float(data1[i]);
+		}
+
+		IVector* vec = IVector::createVector(dim, data1.data(), IVector::PRECISION::FLOAT);
+		IVector* ref = IVector::createVector(dim, rounded1.data());
+		IVector* op = IVector::createVector(dim, data2.data());
+
+		assert(vec->getPrecision() == IVector::PRECISION::FLOAT);
+		assert(ref->getPrecision() == IVector::PRECISION::DOUBLE && ref->getFloatData() == nullptr);
+		assert(vec->getFloatData()[dim - 1] == float(data1[dim - 1]));
+		assert(vec->sizeAllocated() < ref->sizeAllocated());
+
+		// No double coordinates are kept, operations read float ones natively
+		assert(vec->getData() == nullptr);
+		assert(IVector::equals(vec, ref, IVector::NORM::CHEBYSHEV, tol));
+		assert(IVector::equals(ref, vec, IVector::NORM::SECOND, 1.0e-160));
+		assert(vec->setCoord(3, 2.5) == RC::SUCCESS);
+		assert(vec->getFloatData()[3] == 2.5f);
+		assert(ref->setCoord(3, 2.5) == RC::SUCCESS);
+		assert(relativeCompare(IVector::dot(vec, op), IVector::dot(ref, op), tol));
+		assert(relativeCompare(IVector::dot(vec, vec), IVector::dot(ref, ref), tol));
+
+		for (auto n : { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV }) {
+			assert(relativeCompare(vec->norm(n), ref->norm(n), tol));
+		}
+
+		IVector* floatOp = IVector::createVector(dim, data2.data(), IVector::PRECISION::FLOAT);
+
+		// Double vectors of every kind take float operands
+		IVector* sum = ref->clone();
+		IVector* sparse = IVector::createSparseVector(dim, ref->getData());
+		IVector* small = IVector::createVector(4, ref->getData());
+		IVector* smallOp = IVector::createVector(4, data2.data(), IVector::PRECISION::FLOAT);
+		assert(sum->inc(floatOp) == RC::SUCCESS && sparse->axpy(1.0, floatOp) == RC::SUCCESS);
+		assert(small->axpby(1.0, smallOp, 1.0) == RC::SUCCESS);
+		for (size_t i = 0; i < dim; i++) {
+			assert(sum->getData()[i] == ref->getData()[i] + float(data2[i]));
+			assert(i >= 4 || small->getData()[i] == ref->getData()[i] + float(data2[i]));
+		}
+		assert(IVector::equals(sparse, sum, IVector::NORM::CHEBYSHEV, tol));
+		assert(relativeCompare(IVector::dot(sparse, floatOp), IVector::dot(sum, floatOp), tol));
+		delete sum;
+		delete sparse;
+		delete small;
+		delete smallOp;
+
+		assert(vec->inc(op) == RC::SUCCESS);
+		assert(vec->axpby(0.5, floatOp, 2.0) == RC::SUCCESS);
+		for (size_t i = 0; i < dim; i++) {
+			double expected = 0.5 * float(data2[i]) + 2.0 * float(ref->getData()[i] + data2[i]);
+			assert(vec->getFloatData()[i] == float(expected));
+		}
+
+		// Result aliases the first operand, rounding to float happens once
+		IVector* copy = vec->clone();
+		assert(copy->getPrecision() == IVector::PRECISION::FLOAT);
+		const IVector* ops[] = { vec, op, floatOp };
+		const double coeffs[] = { 1.0, -1.0, 3.0 };
+		assert(vec->linearCombination(3, coeffs, ops) == RC::SUCCESS);
+		for (size_t i = 0; i < dim; i++) {
+			double expected = double(copy->getFloatData()[i]) - data2[i] + 3.0 * float(data2[i]);
+			assert(vec->getFloatData()[i] == float(expected));
+		}
+
+		assert(vec->setCoord(0, 1.0e39) == RC::INFINITY_OVERFLOW);
+		std::vector<double> huge(dim, 1.0e39);
+		assert(IVector::createVector(dim, huge.data(), IVector::PRECISION::FLOAT) == nullptr);
+		assert(IVector::createVector(dim, huge.data(), IVector::PRECISION::AMOUNT) == nullptr);
+
+		// Results past float range are rejected before narrowing and leave the last span as it was
+		float before = vec->getFloatData()[dim - 1];
+		assert(vec->scale(1.0e38) == RC::INFINITY_OVERFLOW);
+		assert(vec->axpy(1.0e39, op) == RC::INFINITY_OVERFLOW);
+		assert(vec->applyFunction([](double x) { return x * 1.0e300; }) == RC::INFINITY_OVERFLOW);
+		assert(vec->getFloatData()[dim - 1] == before);
+		assert(std::isfinite(vec->norm(IVector::NORM::CHEBYSHEV)));
+
+		std::vector<float> floatData(dim, 1.5f);
+		IVector* fromFloat = IVector::createVector(dim, floatData.data());
+		assert(fromFloat->getPrecision() == IVector::PRECISION::FLOAT);
+		assert(fromFloat->applyInline([](double x) { return x * x; }) == RC::SUCCESS);
+		assert(fromFloat->getFloatData()[dim - 1] == 2.25f);
+		assert(IVector::copyInstance(ref, fromFloat) == RC::SUCCESS);
+		assert(ref->getData()[0] == 2.25);
+
+		delete fromFloat;
+		delete copy;
+		delete floatOp;
+		delete vec;
+		delete ref;
+		delete op;
+	}
+
+	/*
+	 * Sparse vectors and mixed sparse/dense operations must match the dense ones
+	 */
+	void sparseTest() {
+		size_t dim = 500;
+		double tol = 1.0e-12;
+
+		std::vector<double> data1(dim, 0.0), data2(dim, 0.0), denseData(dim);
+		for (size_t i = 0; i < dim; i += 7) {
+			data1[i] = 0.5 * i - 3;
+		}
+		for (size_t i = 0; i < dim; i += 5) {
+			data2[i] = 1.0 + i;
+		}
+		for (size_t i = 0; i < dim; i++) {
+			denseData[i] = sin(double(i));
+		}
+
+		IVector* sparse1 = IVector::createSparseVector(dim, data1.data());
+		IVector* sparse2 = IVector::createSparseVector(dim, data2.data());
+		IVector* dense1 = IVector::createVector(dim, data1.data());
+		IVector* dense2 = IVector::createVector(dim, data2.data());
+		IVector* dense = IVector::createVector(dim, denseData.data());
+
+		assert(sparse1->getNonZeroIndices() != nullptr && dense1->getNonZeroIndices() == nullptr);
+		assert(sparse1->getNonZeroCount() == (dim + 6) / 7);
+		assert(sparse1->getNonZeroIndices()[1] == 7);
+
+		for (auto n : { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV }) {
+			assert(relativeCompare(sparse1->norm(n), dense1->norm(n), tol));
+			assert(IVector::equals(sparse1, dense1, n, tol) && IVector::equals(dense1, sparse1, n, tol));
+			assert(!IVector::equals(sparse1, sparse2, n, tol));
+		}
+
+		// NaN written into a view is never within tolerance, in a sparse/dense pair as well as a dense one
+		std::vector<double> nanData(data1);
+		nanData[dim / 2] = NAN;
+		IVector* nanView = IVector::createView(dim, nanData.data());
+		for (auto n : { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV }) {
+			assert(!IVector::equals(sparse1, nanView, n, 1.0) && !IVector::equals(nanView, sparse1, n, 1.0));
+			assert(!IVector::equals(dense1, nanView, n, 1.0));
+		}
+		delete nanView;
+
+		assert(relativeCompare(IVector::dot(sparse1, sparse2), IVector::dot(dense1, dense2), tol));
+		assert(relativeCompare(IVector::dot(sparse1, dense), IVector::dot(dense1, dense), tol));
+		assert(relativeCompare(IVector::dot(dense, sparse2), IVector::dot(dense, dense2), tol));
+
+		// Sparse operand of dense vector and the other way round
+		IVector* denseRes = dense->clone();
+		IVector* refRes = dense->clone();
+		assert(denseRes->axpby(-2.0, sparse1, 0.5) == RC::SUCCESS);
+		assert(refRes->axpby(-2.0, dense1, 0.5) == RC::SUCCESS);
+		assert(IVector::equals(denseRes, refRes, IVector::NORM::CHEBYSHEV, tol));
+		assert(denseRes->inc(sparse2) == RC::SUCCESS && refRes->inc(dense2) == RC::SUCCESS);
+		assert(IVector::equals(denseRes, refRes, IVector::NORM::CHEBYSHEV, tol));
+
+		IVector* sparseRes = sparse1->clone();
+		assert(sparseRes->axpy(3.0, sparse2) == RC::SUCCESS);
+		assert(dense1->axpy(3.0, dense2) == RC::SUCCESS);
+		assert(IVector::equals(sparseRes, dense1, IVector::NORM::CHEBYSHEV, tol));
+		assert(sparseRes->dec(sparseRes) == RC::SUCCESS);
+		assert(sparseRes->getNonZeroCount() == 0);
+
+		assert(sparseRes->inc(dense) == RC::SUCCESS);
+		assert(IVector::equals(sparseRes, dense, IVector::NORM::CHEBYSHEV, tol));
+
+		// Coordinates can be set anywhere, zeros are not stored
+		double coord;
+		assert(sparse2->setCoord(1, 4.0) == RC::SUCCESS && sparse2->setCoord(0, 0.0) == RC::SUCCESS);
+		assert(sparse2->getCoord(1, coord) == RC::SUCCESS && coord == 4.0);
+		assert(sparse2->getCoord(0, coord) == RC::SUCCESS && coord == 0.0);
+		assert(sparse2->getNonZeroCount() == dim / 5);
+		assert(sparse2->getData()[1] == 4.0 && sparse2->getData()[5] == 6.0);
+
+		size_t visited = 0;
+		double sum = 0;
+		sparse2->foreachBlock([&](const double* in, size_t n) {
+			for (size_t i = 0; i < n; i++) {
+				sum += in[i];
+			}
+			visited += n;
+		});
+		assert(visited == dim && relativeCompare(sum, sparse2->norm(IVector::NORM::FIRST), tol));
+
+		size_t indices[] = { 3, 2 };
+		double values[] = { 1.0, 2.0 };
+		assert(IVector::createSparseVector(dim, 2, indices, values) == nullptr);
+		indices[1] = dim;
+		assert(IVector::createSparseVector(dim, 2, indices, values) == nullptr);
+
+		delete sparseRes;
+		delete denseRes;
+		delete refRes;
+		delete sparse1;
+		delete sparse2;
+		delete dense1;
+		delete dense2;
+		delete dense;
+	}
+
+	void expressionTest() {
+		using namespace VectorExpression;
+
+		size_t dim = 3000;
+		double tol = 1.0e-12;
+
+		std::vector<double> data1(dim), data2(dim), data3(dim);
+		for (size_t i = 0; i < dim; i++) {
+			data1[i] = sin(double(i));
+			data2[i] = cos(double(i));
+			data3[i] = 0.001 * i;
+		}
+
+		IVector* a = IVector::createVector(dim, data1.data());
+		IVector* b = IVector::createVector(dim, data2.data());
+		IVector* c = IVector::createVector(dim, data3.data(), IVector::PRECISION::FLOAT);
+		IVector* dest = IVector::createVector(dim, data3.data());
+
+		// a + b - 2c materialized step by step
+		IVector* sum = IVector::add(a, b);
+		IVector* ref = sum->clone();
+		assert(ref->axpy(-2.0, c) == RC::SUCCESS);
+
+		assert(assign(dest, expr(a) + expr(b) - 2.0 * expr(c)) == RC::SUCCESS);
+		assert(IVector::equals(dest, ref, IVector::NORM::CHEBYSHEV, tol));
+
+		for (auto n : { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV }) {
+			assert(relativeCompare(norm(expr(a) + expr(b) - expr(c) * 2.0, n), ref->norm(n), tol));
+		}
+		assert(relativeCompare(dot(expr(a) + expr(b), expr(c)), IVector::dot(sum, c), tol));
+
+		double product = 0;
+		for (size_t i = 0; i < dim; i++) {
+			product += data1[i] * data2[i] * static_cast<float>(data3[i]);
+		}
+		assert(relativeCompare(dot(expr(a) * expr(b), -expr(c)), -product, tol));
+
+		// Destination may be an operand, every coordinate is read before it is overwritten
+		assert(assign(dest, expr(dest) - expr(ref)) == RC::SUCCESS);
+		assert(dest->norm(IVector::NORM::CHEBYSHEV) <= tol);
+
+		assert(assign(c, 0.5 * (expr(c) + expr(c))) == RC::SUCCESS);
+		for (size_t i = 0; i < dim; i++) {
+			double coord;
+			assert(c->getCoord(i, coord) == RC::SUCCESS && coord == static_cast<float>(data3[i]));
+		}
+
+		// NaN written into a view propagates as in IVector reductions
+		std::vector<double> nanData(data1);
+		nanData[dim / 3] = NAN;
+		IVector* nanView = IVector::createView(dim, nanData.data());
+		for (auto n : { IVector::NORM::FIRST, IVector::NORM::SECOND, IVector::NORM::CHEBYSHEV }) {
+			assert(std::isnan(norm(expr(nanView), n)) && std::isnan(nanView->norm(n)));
+		}
+		assert(std::isnan(dot(expr(nanView), expr(a))) && std::isnan(IVector::dot(nanView, a)));
+		delete nanView;
+
+		// Sums follow the summation mode, compensated one keeps units a naive loop absorbs into 1e16
+		std::vector<double> illData(dim), ones(dim, 1.0);
+		for (size_t i = 0; i < dim; i++) {
+			illData[i] = i % 2 == 1 ? 1.0 : (i % 4 == 0 ? 1.0e16 : -1.0e16);
+		}
+		IVector* ill = IVector::createVector(dim, illData.data());
+		IVector* unit = IVector::createVector(dim, ones.data());
+		IVector::SUMMATION initialMode = IVector::getSummation();
+		assert(IVector::setSummation(IVector::SUMMATION::COMPENSATED) == RC::SUCCESS);
+		assert(IVector::dot(ill, unit) == double(dim / 2));
+		assert(dot(expr(ill), expr(unit)) == IVector::dot(ill, unit));
+		for (auto n : { IVector::NORM::FIRST, IVector::NORM::SECOND }) {
+			assert(norm(expr(ill), n) == ill->norm(n));
+		}
+		IVector::setSummation(initialMode);
+		delete ill;
+		delete unit;
+
+		IVector* shorter = IVector::createVector(dim - 1, data1.data());
+		assert(assign(dest, expr(a) + expr(shorter)) == RC::MISMATCHING_DIMENSIONS);
+		assert(assign(shorter, expr(a) + expr(b)) == RC::MISMATCHING_DIMENSIONS);
+		assert(assign(dest, expr(a) + expr(nullptr)) == RC::NULLPTR_ERROR);
+		assert(std::isnan(norm(expr(a) - expr(shorter), IVector::NORM::SECOND)));
+		assert(std::isnan(dot(expr(a), expr(shorter))));
+
+		delete shorter;
+		delete sum;
+		delete ref;
+		delete a;
+		delete b;
+		delete c;
+		delete dest;
+	}
+
+	void moveTest() {
+		size_t dim = 20000;
+		std::vector<double> data1(dim, 1.0), data2(dim, 2.0);
+
+		// Large vectors hand their coordinates over
+		IVector* dest = IVector::createVector(dim, data1.data());
+		IVector* src = IVector::createVector(dim, data2.data());
+		const double* srcData = src->getData();
+		assert(IVector::moveInstance(dest, src) == RC::SUCCESS);
+		assert(src == nullptr && dest->getData() == srcData && dest->getData()[dim - 1] == 2.0);
+
+		IVector* floatDest = IVector::createVector(dim, data1.data(), IVector::PRECISION::FLOAT);
+		IVector* floatSrc = IVector::createVector(dim, data2.data(), IVector::PRECISION::FLOAT);
+		const float* floatSrcData = floatSrc->getFloatData();
+		assert(IVector::moveInstance(floatDest, floatSrc) == RC::SUCCESS);
+		assert(floatDest->getFloatData() == floatSrcData && floatDest->getFloatData()[0] == 2.0f);
+
+		IVector* sparseDest = IVector::createSparseVector(dim, data1.data());
+		IVector* sparseSrc = IVector::createSparseVector(dim, data2.data());
+		const double* valuesSrc = sparseSrc->getNonZeroValues();
+		assert(IVector::moveInstance(sparseDest, sparseSrc) == RC::SUCCESS);
+		assert(sparseDest->getNonZeroValues() == valuesSrc && sparseDest->getData()[1] == 2.0);
+
+		// Different kinds fall back to copying
+		src = IVector::createVector(dim, data1.data());
+		assert(IVector::moveInstance(floatDest, src) == RC::SUCCESS);
+		assert(src == nullptr && floatDest->getFloatData()[dim - 1] == 1.0f);
+
+		std::vector<double> buffer(dim, 0.0);
+		IVector* view = IVector::createView(dim, buffer.data());
+		src = IVector::createVector(dim, data2.data());
+		assert(IVector::moveInstance(view, src) == RC::SUCCESS);
+		assert(buffer[dim - 1] == 2.0);
+
+		// Small vectors keep inline coordinates and are copied
+		IVector* small = IVector::createVector(10, data1.data());
+		src = IVector::createVector(10, data2.data());
+		assert(IVector::moveInstance(small, src) == RC::SUCCESS && small->getData()[9] == 2.0);
+
+		src = IVector::createVector(dim - 1, data2.data());
+		assert(IVector::moveInstance(dest, src) == RC::MISMATCHING_DIMENSIONS && src != nullptr);
+		assert(IVector::moveInstance(dest, dest) == RC::MEMORY_INTERSECTION);
+
+		delete src;
+		delete small;
+		delete view;
+		delete sparseDest;
+		delete floatDest;
+		delete dest;
+	}
+
+	void fileTest() {
+		const char* path = "VectorFileTest.bin";
+		std::vector<double> data1 = { 1, 2, 3 }, data2(1000), data3 = { -1 };
+		for (size_t i = 0; i < data2.size(); i++) {
+			data2[i] = sin(double(i));
+		}
+
+		IVector* vec1 = IVector::createVector(data1.size(), data1.data());
+		IVector* vec2 = IVector::createVector(data2.size(), data2.data(), IVector::PRECISION::FLOAT);
+		IVector* vec3 = IVector::createVector(data3.size(), data3.data());
+
+		IVectorFile::IWriter* writer = IVectorFile::createWriter(path);
+		assert(writer->append(vec1) == RC::SUCCESS && writer->append(vec2) == RC::SUCCESS);
+		assert(writer->append(nullptr) == RC::NULLPTR_ERROR && writer->getCount() == 2);
+		delete writer;
+
+		writer = IVectorFile::createWriter(path, true);
+		assert(writer->getCount() == 2 && writer->append(vec3) == RC::SUCCESS);
+		delete writer;
+
+		IVectorFile* file = IVectorFile::load(path);
+		assert(file && file->getCount() == 3);
+
+		const IVector* ops[] = { vec1, vec2, vec3 };
+		for (size_t i = 0; i < file->getCount(); i++) {
+			const IVector* loaded = file->getVector(i);
+			assert(loaded->getDim() == ops[i]->getDim());
+			assert(reinterpret_cast<uintptr_t>(loaded->getData()) % 64 == 0);
+			for (size_t j = 0; j < loaded->getDim(); j++) {
+				double coord;
+				assert(ops[i]->getCoord(j, coord) == RC::SUCCESS && loaded->getData()[j] == coord);
+			}
+		}
+		assert(file->getVector(3) == nullptr);
+		delete file;
+
+		assert(IVectorFile::save(path, 2, ops + 1) == RC::SUCCESS);
+		file = IVectorFile::load(path);
+		assert(file && file->getCount() == 2 && file->getVector(1)->getData()[0] == -1.0);
+		delete file;
+
+		// Anything else is rejected and is not overwritten by appending writer
+		FILE* text = fopen(path, "w");
+		fputs("1 2 3", text);
+		fclose(text);
+		assert(IVectorFile::load(path) == nullptr && IVectorFile::createWriter(path, true) == nullptr);
+		assert(IVectorFile::load("MissingVectorFile.bin") == nullptr);
+
+		std::remove(path);
+		delete vec1;
+		delete vec2;
+		delete vec3;
+	}
+
+	void countersTest() {
+		size_t dim = 100;
+		std::vector<double> data(dim, 1.0);
+		IVector* vec = IVector::createVector(dim, data.data());
+
+		if (IVector::setCountersEnabled(true) != RC::SUCCESS) {
+			std::cout << "Operation counters are not built in" << std::endl;
+			delete vec;
+			return;
+		}
+		assert(IVector::isCountersEnabled() && IVector::resetOperationCounters() == RC::SUCCESS);
+
+		IVector* copy = vec->clone();
+		assert(copy->inc(vec) == RC::SUCCESS && copy->axpy(2.0, vec) == RC::SUCCESS);
+		assert(IVector::dot(vec, copy) == 4.0 * dim);
+		vec->norm(IVector::NORM::SECOND);
+		assert(IVector::sub(copy, vec, copy) == RC::SUCCESS);
+
+		IVector::OperationCounters counters = IVector::getOperationCounters();
+		auto calls = [&counters](IVector::OPERATION op) { return counters.calls[static_cast<size_t>(op)]; };
+		assert(calls(IVector::OPERATION::CLONE) == 1 && calls(IVector::OPERATION::CREATE) == 1);
+		assert(calls(IVector::OPERATION::UPDATE) == 2 && calls(IVector::OPERATION::DOT) == 1);
+		assert(calls(IVector::OPERATION::NORM) == 1 && calls(IVector::OPERATION::EQUALS) == 0);
+		assert(calls(IVector::OPERATION::SUB) == 1 && calls(IVector::OPERATION::ADD) == 0);
+		assert(counters.coordinates[static_cast<size_t>(IVector::OPERATION::UPDATE)] == 2 * dim);
+		assert(counters.allocations == 1 && counters.bytesAllocated >= dim * sizeof(double));
+
+		// Nothing is counted while disabled
+		assert(IVector::setCountersEnabled(false) == RC::SUCCESS);
+		vec->norm(IVector::NORM::SECOND);
+		assert(IVector::getOperationCounters().calls[static_cast<size_t>(IVector::OPERATION::NORM)] == 1);
+
+		IVector::resetOperationCounters();
+		assert(IVector::getOperationCounters().allocations == 0);
+
+		delete copy;
+		delete vec;
+	}
+
+	void summationTest() {
+		assert(IVector::getSummation() == IVector::SUMMATION::PAIRWISE);
+
+		size_t dim = 1000000;
+		std::vector<double> data(dim), ones(dim, 1.0);
+		long double exact = 0;
+		for (size_t i = 0; i < dim; i++) {
+			data[i] = 0.1 + 1.0e-3 * sin(double(i));
+			exact += data[i];
+		}
+
+		IVector* vec = IVector::createVector(dim, data.data());
+		IVector* unit = IVector::createVector(dim, ones.data());
+
+		// Compensated sum is correctly rounded up to a couple of ulps
+		for (auto mode : { IVector::SUMMATION::PAIRWISE, IVector::SUMMATION::COMPENSATED }) {
+			assert(IVector::setSummation(mode) == RC::SUCCESS);
+			double error = fabs(double(vec->norm(IVector::NORM::FIRST) - exact)) / double(exact);
+			std::cout << (mode == IVector::SUMMATION::PAIRWISE ? "Pairwise" : "Compensated")
+					  << " summation relative error: " << error << std::endl;
+			double bound = mode == IVector::SUMMATION::PAIRWISE ? 1.0e-14 : 5.0e-16;
+			assert(error < bound);
+			assert(relativeCompare(IVector::dot(vec, unit), double(exact), bound));
+		}
+
+		// Only compensated summation keeps small terms next to cancelling huge ones. Sparse dot and
+		// fixed-size norm add terms in order, so their pairwise results are known exactly
+		double values[] = { 1.0, 1.0e100, 1.0, -1.0e100 };
+		double small[] = { 1.0, 1.0e-16, 1.0e-16, 1.0e-16, 1.0e-16, 1.0e-16, 1.0e-16, 1.0e-16 };
+		IVector* cancelling = IVector::createVector(4, values);
+		IVector* cancellingSparse = IVector::createSparseVector(4, values);
+		IVector* cancellingUnit = IVector::createVector(4, ones.data());
+		IVector* fixed = IVector::createVector(8, small);
+
+		assert(IVector::setSummation(IVector::SUMMATION::PAIRWISE) == RC::SUCCESS);
+		assert(IVector::dot(cancellingSparse, cancellingUnit) == 0.0);
+		assert(IVector::dot(cancellingSparse, cancellingSparse) == 2.0e200);
+		assert(fixed->norm(IVector::NORM::FIRST) == 1.0);
+
+		assert(IVector::setSummation(IVector::SUMMATION::COMPENSATED) == RC::SUCCESS);
+		assert(IVector::dot(cancelling, cancellingUnit) == 2.0);
+		assert(IVector::dot(cancellingSparse, cancellingUnit) == 2.0);
+		assert(fixed->norm(IVector::NORM::FIRST) > 1.0);
+
+		// Sparse-sparse dot merges more products than one block
+		std::vector<double> alternating(dim);
+		for (size_t i = 0; i < dim; i += 2) {
+			alternating[i] = i % 4 == 0 ? 1.0e100 : -1.0e100;
+			alternating[i + 1] = 1.0;
+		}
+		IVector* sparse = IVector::createSparseVector(dim, alternating.data());
+		IVector* sparseUnit = IVector::createSparseVector(dim, ones.data());
+		assert(IVector::dot(sparse, sparseUnit) == double(dim / 2));
+		assert(IVector::setSummation(IVector::SUMMATION::PAIRWISE) == RC::SUCCESS);
+		assert(IVector::dot(sparse, sparseUnit) != double(dim / 2));
+
+		IVector* sparseVec = IVector::createSparseVector(dim, data.data());
+		assert(relativeCompare(IVector::dot(sparseVec, sparseUnit), double(exact), 1.0e-14));
+		delete sparseVec;
+
+		delete sparse;
+		delete sparseUnit;
+		delete cancellingSparse;
+		delete fixed;
+
+		assert(IVector::setSummation(IVector::SUMMATION::AMOUNT) == RC::INVALID_ARGUMENT);
+		assert(IVector::setSummation(IVector::SUMMATION::PAIRWISE) == RC::SUCCESS);
+
+		delete cancelling;
+		delete cancellingUnit;
+		delete vec;
+		delete unit;
+	}
+
+	void poolTest() {
+		size_t dim = 100;
+		std::vector<double> data(dim, 1.0);
+
+		IVector::trimPool();
+		assert(IVector::getPoolStatistics().bytesRetained == 0);
+
+		IVector* vec = IVector::createVector(dim, data.data());
+		delete vec;
+		assert(IVector::getPoolStatistics().bytesRetained > 0);
+
+		IVector::PoolStatistics before = IVector::getPoolStatistics();
+		for (int i = 0; i < 100; i++) {
+			vec = IVector::createVector(dim, data.data());
+			delete vec;
+		}
+		IVector::PoolStatistics after = IVector::getPoolStatistics();
+		std::cout << "Pool hits: " << after.hits - before.hits << ", misses: " << after.misses - before.misses
+				  << std::endl;
+		assert(after.hits - before.hits == 100);
+		assert(after.misses == before.misses);
+
+		IVector::trimPool();
+		assert(IVector::getPoolStatistics().bytesRetained == 0);
+
+		// Another thread drains its cache on its next allocation after trim
+		std::atomic<bool> isFreed(false);
+		std::atomic<bool> isTrimmed(false);
+		std::thread worker([&]() {
+			IVector* local = IVector::createVector(dim, data.data());
+			delete local;
+			isFreed = true;
+			while (!isTrimmed) {
+				std::this_thread::yield();
+			}
+			local = IVector::createVector(dim, data.data());
+			delete local;
+		});
+		while (!isFreed) {
+			std::this_thread::yield();
+		}
+		IVector::trimPool();
+		IVector::PoolStatistics trimmed = IVector::getPoolStatistics();
+		assert(trimmed.bytesRetained > 0);
+		isTrimmed = true;
+		worker.join();
+
+		// Drained block was not reused, the one freed again went to the shared pool on exit
+		IVector::PoolStatistics joined = IVector::getPoolStatistics();
+		assert(joined.misses == trimmed.misses + 1 && joined.hits == trimmed.hits);
+		assert(joined.bytesRetained == trimmed.bytesRetained);
+		IVector::trimPool();
+		assert(IVector::getPoolStatistics().bytesRetained == 0);
+
+		// Limit below one block keeps thread cache empty as well
+		IVector::setPoolRetentionLimit(1);
+		vec = IVector::createVector(dim, data.data());
+		delete vec;
+		assert(IVector::getPoolStatistics().bytesRetained == 0);
+
+		IVector::setPoolRetentionLimit(0);
+		vec = IVector::createVector(dim, data.data());
+		delete vec;
+		assert(IVector::getPoolStatistics().bytesRetained == 0);
+
+		IVector::setPoolRetentionLimit(64 * 1024 * 1024);
+	}
+
+} // namespace
+
 void Tests::vectorTest(ILogger* logger) {
 	IVector::setLogger(logger);
 
@@ -27,6 +1015,22 @@ void Tests::vectorTest(ILogger* logger) {
 	PrintUtils::printVector(subRes);
 	assert(IVector::equals(subRes, correctSubRes, IVector::NORM::SECOND, tol));
 
+	std::cout << "Subtraction into existing vector: ";
+	IVector* subDest = IVector::createVector(dim, std::vector<double>(dim).data());
+	assert(IVector::sub(vec1, vec2, subDest) == RC::SUCCESS);
+	PrintUtils::printVector(subDest);
+	assert(IVector::equals(subDest, correctSubRes, IVector::NORM::SECOND, tol));
+
+	std::cout << "Addition in place of first operand: ";
+	assert(IVector::add(subDest, vec2, subDest) == RC::SUCCESS);
+	PrintUtils::printVector(subDest);
+	assert(IVector::equals(subDest, vec1, IVector::NORM::SECOND, tol));
+
+	IVector* wrongDim = IVector::createVector(1, std::vector<double>{ 0 }.data());
+	assert(IVector::add(vec1, vec2, wrongDim) == RC::MISMATCHING_DIMENSIONS);
+	delete wrongDim;
+
+	delete subDest;
 	delete subRes;
 	delete correctSubRes;
 
@@ -74,7 +1078,42 @@ void Tests::vectorTest(ILogger* logger) {
 	PrintUtils::printVector(vec2);
 	assert(rc != RC::SUCCESS);
 
+	std::cout << "Trying set data with NaN in Vector B: ";
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	IVector* vec2Copy = vec2->clone();
+	rc = vec2->setData(dim, std::vector<double>{1, nan, 3}.data());
+	PrintUtils::printVector(vec2);
+	assert(rc == RC::NOT_NUMBER);
+	assert(IVector::equals(vec2, vec2Copy, IVector::NORM::SECOND, tol));
+
+	delete vec2Copy;
+
+	std::cout << "Trying to scale Vector B to infinity: ";
+	rc = vec2->scale(std::numeric_limits<double>::max());
+	rc = rc == RC::SUCCESS ? vec2->scale(std::numeric_limits<double>::max()) : rc;
+	PrintUtils::printVector(vec2);
+	assert(rc == RC::INFINITY_OVERFLOW);
+
+	rc = vec2->applyFunction([nan](double) { return nan; });
+	assert(rc == RC::NOT_NUMBER);
+
 	delete vec2;
 
+	instructionSetsTest();
+	alignmentTest();
+	viewTest();
+	fixedDimensionTest();
+	blockFunctionTest();
+	failedUpdateTest();
+	parallelTest();
+	floatStorageTest();
+	sparseTest();
+	expressionTest();
+	moveTest();
+	fileTest();
+	countersTest();
+	summationTest();
+	poolTest();
+
 	std::cout << "Vector test successfully finished\n\n";
 }
\ No newline at end of file